@@ -86,6 +86,9 @@ class U8G2
     uint8_t getCols(void) { return u8x8_GetCols(u8g2_GetU8x8(&u8g2)); }
     uint8_t getRows(void) { return u8x8_GetRows(u8g2_GetU8x8(&u8g2)); }
     void drawTile(uint8_t x, uint8_t y, uint8_t cnt, uint8_t *tile_ptr) {
+#ifdef U8G2_WITH_PAGE_HASH
+      u8g2_InvalidatePageHash(&u8g2);
+#endif
       u8x8_DrawTile(u8g2_GetU8x8(&u8g2), x, y, cnt, tile_ptr); }
 
 #ifdef U8X8_WITH_USER_PTR
@@ -116,6 +119,9 @@ class U8G2
     uint8_t getMenuEvent(void) { return u8x8_GetMenuEvent(u8g2_GetU8x8(&u8g2)); }
 
     void initDisplay(void) {
+#ifdef U8G2_WITH_PAGE_HASH
+      u8g2_InvalidatePageHash(&u8g2);
+#endif
       u8g2_InitDisplay(&u8g2); }
       
     /* call initInterface if the uC comes out of deep sleep mode and display is already running */
@@ -130,6 +136,9 @@ class U8G2
       u8g2_SetPowerSave(&u8g2, is_enable); }
       
     void setFlipMode(uint8_t mode) {
+#ifdef U8G2_WITH_PAGE_HASH
+      u8g2_InvalidatePageHash(&u8g2);
+#endif
       u8g2_SetFlipMode(&u8g2, mode); }
 
     void setContrast(uint8_t value) {
@@ -189,6 +198,11 @@ class U8G2
     
     void firstPage(void) { u8g2_FirstPage(&u8g2); }
     uint8_t nextPage(void) { return u8g2_NextPage(&u8g2); }
+#ifdef U8G2_WITH_PAGE_HASH
+    void invalidatePageHash(void) { u8g2_InvalidatePageHash(&u8g2); }
+    uint32_t getPageSendCount(void) { return u8g2_GetPageSendCount(&u8g2); }
+    uint32_t getPageSkipCount(void) { return u8g2_GetPageSkipCount(&u8g2); }
+#endif /* U8G2_WITH_PAGE_HASH */
     
     #ifdef U8G2_USE_DYNAMIC_ALLOC
     void setBufferPtr(uint8_t *buf) { u8g2_SetBufferPtr(&u8g2, buf); }
@@ -211,6 +225,8 @@ class U8G2
       { u8g2_UpdateDisplay(&u8g2); }
     void refreshDisplay(void)
       { u8x8_RefreshDisplay(u8g2_GetU8x8(&u8g2)); }
+    void setStartLine(uint8_t line)		// Only SSD1306/SH1106
+      { u8x8_SetStartLine(u8g2_GetU8x8(&u8g2), line); }
     
 
 
@@ -273,6 +273,9 @@ class U8X8
 
     void refreshDisplay(void) {			// Dec 16: Only required for SSD1606
       u8x8_RefreshDisplay(&u8x8); }
+
+    void setStartLine(uint8_t line) {		// Only SSD1306/SH1106
+      u8x8_SetStartLine(&u8x8, line); }
       
     void clearLine(uint8_t line) {
       u8x8_ClearLine(&u8x8, line); }
@@ -120,6 +120,21 @@
 #define U8G2_WITH_CLIP_WINDOW_SUPPORT
 #endif
 
+/*
+  Enable page hashing in the picture loop:
+    u8g2_NextPage() calculates a hash of every tile row of the buffer and does not
+    send rows, which are already shown on the display with the same content.
+    Anything which writes to the display RAM outside of the picture loop (u8x8_DrawTile)
+    must call u8g2_InvalidatePageHash().
+  Only the first U8G2_PAGE_HASH_ROWS (at most 32) tile rows are tracked, all other rows are always sent.
+  Page hashing requires 4 bytes RAM per tracked tile row.
+  It is disabled by default, define U8G2_WITH_PAGE_HASH in the build flags to enable it.
+*/
+
+#ifndef U8G2_PAGE_HASH_ROWS
+#define U8G2_PAGE_HASH_ROWS 16
+#endif
+
 /*
   The following macro enables all four drawing directions for glyphs and strings.
   If this macro is not defined, than a string can be drawn only in horizontal direction.
@@ -382,6 +397,13 @@ struct u8g2_struct
 					
 	// the following variable should be renamed to is_buffer_auto_clear
   uint8_t is_auto_page_clear; 		/* set to 0 to disable automatic clear of the buffer in firstPage() and nextPage() */
+
+#ifdef U8G2_WITH_PAGE_HASH
+  uint32_t page_hash[U8G2_PAGE_HASH_ROWS];	/* hash of the tile rows, which have been sent to the display */
+  uint32_t page_hash_valid;		/* bit n is set if page_hash[n] matches the display RAM */
+  uint32_t page_send_cnt;		/* number of tile rows sent by u8g2_NextPage() */
+  uint32_t page_skip_cnt;		/* number of tile rows skipped by u8g2_NextPage() */
+#endif /* U8G2_WITH_PAGE_HASH */
   
 };
 
@@ -1567,6 +1589,13 @@ void u8g2_SetBufferCurrTileRow(u8g2_t *u8g2, uint8_t row) U8G2_NOINLINE;
 void u8g2_FirstPage(u8g2_t *u8g2);
 uint8_t u8g2_NextPage(u8g2_t *u8g2);
 
+#ifdef U8G2_WITH_PAGE_HASH
+/* forget the content of the display RAM, the next picture loop sends all tile rows */
+#define u8g2_InvalidatePageHash(u8g2) ((u8g2)->page_hash_valid = 0)
+#define u8g2_GetPageSendCount(u8g2) ((u8g2)->page_send_cnt)
+#define u8g2_GetPageSkipCount(u8g2) ((u8g2)->page_skip_cnt)
+#endif /* U8G2_WITH_PAGE_HASH */
+
 // Add ability to set buffer pointer
 #ifdef __ARM_LINUX__
 #define U8G2_USE_DYNAMIC_ALLOC
@@ -89,9 +89,92 @@ static void u8g2_send_buffer(u8g2_t *u8g2)
   } while( src_row < src_max && dest_row < dest_max );
 }
 
+#ifdef U8G2_WITH_PAGE_HASH
+/* FNV-1a over one tile row of the buffer */
+static uint32_t u8g2_hash_tile_row(u8g2_t *u8g2, uint8_t src_tile_row)
+{
+  uint8_t *ptr;
+  uint16_t cnt;
+  uint32_t hash;
+  
+  cnt = u8g2_GetU8x8(u8g2)->display_info->tile_width;
+  cnt *= 8;
+  ptr = u8g2->tile_buf_ptr;
+  ptr += src_tile_row * cnt;
+  hash = 2166136261UL;
+  do
+  {
+    hash ^= *ptr++;
+    hash *= 16777619UL;
+    cnt--;
+  } while( cnt > 0 );
+  return hash;
+}
+
+/* the display RAM of these tile rows is written without a known hash */
+static void u8g2_invalidate_tile_rows(u8g2_t *u8g2, uint8_t dest_row, uint8_t cnt)
+{
+  while( cnt > 0 && dest_row < U8G2_PAGE_HASH_ROWS )
+  {
+    u8g2->page_hash_valid &= ~(((uint32_t)1) << dest_row);
+    dest_row++;
+    cnt--;
+  }
+}
+
+/* 
+  same as u8g2_send_buffer, but tile rows, which already show the same content
+  on the display, are not transferred again
+*/
+static void u8g2_send_changed_buffer(u8g2_t *u8g2)
+{
+  uint8_t src_row;
+  uint8_t src_max;
+  uint8_t dest_row;
+  uint8_t dest_max;
+  uint32_t hash;
+  uint32_t mask;
+
+  src_row = 0;
+  src_max = u8g2->tile_buf_height;
+  dest_row = u8g2->tile_curr_row;
+  dest_max = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  
+  do
+  {
+    if ( dest_row < U8G2_PAGE_HASH_ROWS )
+    {
+      hash = u8g2_hash_tile_row(u8g2, src_row);
+      mask = ((uint32_t)1) << dest_row;
+      if ( (u8g2->page_hash_valid & mask) != 0 && u8g2->page_hash[dest_row] == hash )
+      {
+	u8g2->page_skip_cnt++;
+      }
+      else
+      {
+	u8g2_send_tile_row(u8g2, src_row, dest_row);
+	u8g2->page_hash[dest_row] = hash;
+	u8g2->page_hash_valid |= mask;
+	u8g2->page_send_cnt++;
+      }
+    }
+    else
+    {
+      u8g2_send_tile_row(u8g2, src_row, dest_row);
+      u8g2->page_send_cnt++;
+    }
+    src_row++;
+    dest_row++;
+  } while( src_row < src_max && dest_row < dest_max );
+}
+#endif /* U8G2_WITH_PAGE_HASH */
+
 /* same as u8g2_send_buffer but also send the DISPLAY_REFRESH message (used by SSD1606) */
 void u8g2_SendBuffer(u8g2_t *u8g2)
 {
+#ifdef U8G2_WITH_PAGE_HASH
+  u8g2_invalidate_tile_rows(u8g2, u8g2->tile_curr_row, u8g2->tile_buf_height);
+#endif /* U8G2_WITH_PAGE_HASH */
   u8g2_send_buffer(u8g2);
   u8x8_RefreshDisplay( u8g2_GetU8x8(u8g2) );  
 }
@@ -116,7 +199,11 @@ void u8g2_FirstPage(u8g2_t *u8g2)
 uint8_t u8g2_NextPage(u8g2_t *u8g2)
 {
   uint8_t row;
+#ifdef U8G2_WITH_PAGE_HASH
+  u8g2_send_changed_buffer(u8g2);
+#else
   u8g2_send_buffer(u8g2);
+#endif /* U8G2_WITH_PAGE_HASH */
   row = u8g2->tile_curr_row;
   row += u8g2->tile_buf_height;
   if ( row >= u8g2_GetU8x8(u8g2)->display_info->tile_height )
@@ -165,6 +252,10 @@ void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, u
   ptr += tx*8;
   ptr += page_size*ty;
   
+#ifdef U8G2_WITH_PAGE_HASH
+  u8g2_invalidate_tile_rows(u8g2, ty, th);
+#endif /* U8G2_WITH_PAGE_HASH */
+  
   while( th > 0 )
   {
     u8x8_DrawTile( u8g2_GetU8x8(u8g2), tx, ty, tw, ptr );
@@ -177,6 +268,9 @@ void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, u
 /* same as sendBuffer, but does not send the ePaper refresh message */
 void u8g2_UpdateDisplay(u8g2_t *u8g2)
 {
+#ifdef U8G2_WITH_PAGE_HASH
+  u8g2_invalidate_tile_rows(u8g2, u8g2->tile_curr_row, u8g2->tile_buf_height);
+#endif /* U8G2_WITH_PAGE_HASH */
   u8g2_send_buffer(u8g2);
 }
 
@@ -89,6 +89,12 @@ void u8g2_SetupBuffer(u8g2_t *u8g2, uint8_t *buf, uint8_t tile_buf_height, u8g2_
   u8g2->draw_color = 1;
   u8g2->is_auto_page_clear = 1;
   
+#ifdef U8G2_WITH_PAGE_HASH
+  u8g2->page_hash_valid = 0;
+  u8g2->page_send_cnt = 0;
+  u8g2->page_skip_cnt = 0;
+#endif /* U8G2_WITH_PAGE_HASH */
+  
   u8g2->cb = u8g2_cb;
   u8g2->cb->update_dimension(u8g2);
 #ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
@@ -356,6 +356,7 @@ struct u8x8_struct
 					/* i2c_address is the address for writing data to the display */
 					/* usually, the lowest bit must be zero for a valid address */
   uint8_t i2c_started;	/* for i2c interface */
+  uint8_t start_line;	/* display RAM line shown in the top row, see U8X8_MSG_DISPLAY_SET_START_LINE */
   //uint8_t device_address;	/* OBSOLETE???? - this is the device address, replacement for U8X8_MSG_CAD_SET_DEVICE */
   uint8_t utf8_state;		/* number of chars which are still to scan */
   uint8_t gpio_result;	/* return value from the gpio call (only for MENU keys at the moment) */ 
@@ -533,6 +534,21 @@ void u8x8_d_helper_display_init(u8x8_t *u8g2);
 */
 #define U8X8_MSG_DISPLAY_REFRESH 16
 
+/*
+  Name: 	U8X8_MSG_DISPLAY_SET_START_LINE
+  Args:	
+    arg_int: display RAM line, which is shown in the top row of the display
+  
+  Hardware vertical scrolling: The display shows the RAM starting with
+  line arg_int, lines above wrap around to the bottom. A multiple of 8
+  flips whole pages without any RAM transfer.
+  Only supported by the SSD1306/SH1106 family, other displays ignore this message.
+  Use
+    void u8x8_SetStartLine(u8x8_t *u8x8, uint8_t line)
+  to send the message to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_SET_START_LINE 17
+
 /*==========================================*/
 /* u8x8_setup.c */
 
@@ -583,6 +599,7 @@ void u8x8_ClearDisplayWithTile(u8x8_t *u8x8, const uint8_t *buf)  U8X8_NOINLINE;
 void u8x8_ClearDisplay(u8x8_t *u8x8);	// this does not work for u8g2 in some cases
 void u8x8_FillDisplay(u8x8_t *u8x8);
 void u8x8_RefreshDisplay(u8x8_t *u8x8);	// make RAM content visible on the display (Dec 16: SSD1606 only)
+void u8x8_SetStartLine(u8x8_t *u8x8, uint8_t line);	// hardware vertical scroll (SSD1306/SH1106 only)
 void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line);
 
 
@@ -675,6 +692,9 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 
 #define U8X8_MSG_BYTE_INIT U8X8_MSG_CAD_INIT
 #define U8X8_MSG_BYTE_SET_DC 32
+/* arg_ptr points to an uint8_t with the default burst size. A byte procedure without */
+/* a limit for the number of data bytes in one transfer may overwrite this value */
+#define U8X8_MSG_BYTE_GET_MAX_BURST 33
 
 #define U8X8_MSG_BYTE_SEND U8X8_MSG_CAD_SEND_DATA
 
@@ -690,6 +710,7 @@ uint8_t u8x8_byte_SendByte(u8x8_t *u8x8, uint8_t byte) U8X8_NOINLINE;
 uint8_t u8x8_byte_SendBytes(u8x8_t *u8x8, uint8_t cnt, uint8_t *data) U8X8_NOINLINE;
 uint8_t u8x8_byte_StartTransfer(u8x8_t *u8x8);
 uint8_t u8x8_byte_EndTransfer(u8x8_t *u8x8);
+uint8_t u8x8_byte_GetMaxBurst(u8x8_t *u8x8, uint8_t default_burst);
 
 uint8_t u8x8_byte_empty(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_byte_4wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
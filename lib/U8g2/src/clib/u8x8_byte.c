@@ -61,6 +61,17 @@ uint8_t u8x8_byte_EndTransfer(u8x8_t *u8x8)
   return u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_END_TRANSFER, 0, NULL);
 }
 
+/* max number of data bytes, which can be sent within one transfer */
+/* byte procedures, which do not know the message, keep default_burst */
+uint8_t u8x8_byte_GetMaxBurst(u8x8_t *u8x8, uint8_t default_burst)
+{
+  uint8_t burst = default_burst;
+  u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_GET_MAX_BURST, 0, (void *)&burst);
+  if ( burst == 0 )
+    return default_burst;
+  return burst;
+}
+
 /*=========================================*/
 
 uint8_t u8x8_byte_empty(U8X8_UNUSED u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t arg_int, U8X8_UNUSED void *arg_ptr)
@@ -605,6 +616,10 @@ uint8_t u8x8_byte_sw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_p
     case U8X8_MSG_BYTE_END_TRANSFER:
       i2c_stop(u8x8);
       break;
+    case U8X8_MSG_BYTE_GET_MAX_BURST:
+      /* bits are clocked directly to the pins, there is no buffer limit */
+      *(uint8_t *)arg_ptr = 255;
+      break;
     default:
       return 0;
   }
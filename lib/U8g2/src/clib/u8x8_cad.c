@@ -483,6 +483,7 @@ static void u8x8_i2c_data_transfer(u8x8_t *u8x8, uint8_t arg_int, void *arg_ptr)
 uint8_t u8x8_cad_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t *p;
+  uint8_t burst;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
@@ -505,12 +506,14 @@ uint8_t u8x8_cad_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       /* Unfortunately, this can not be handled in the byte level drivers, */
       /* so this is done here. Even further, only 24 bytes will be sent, */
       /* because there will be another byte (DC) required during the transfer */
+      /* Byte procedures without such a buffer report a larger burst size */
+      burst = u8x8_byte_GetMaxBurst(u8x8, 24);
       p = arg_ptr;
-       while( arg_int > 24 )
+       while( arg_int > burst )
       {
-	u8x8_i2c_data_transfer(u8x8, 24, p);
-	arg_int-=24;
-	p+=24;
+	u8x8_i2c_data_transfer(u8x8, burst, p);
+	arg_int-=burst;
+	p+=burst;
       }
       u8x8_i2c_data_transfer(u8x8, arg_int, p);
       break;
@@ -535,6 +538,7 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 {
   static uint8_t in_transfer = 0;
   uint8_t *p;
+  uint8_t burst;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
@@ -575,12 +579,14 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       /* Unfortunately, this can not be handled in the byte level drivers, */
       /* so this is done here. Even further, only 24 bytes will be sent, */
       /* because there will be another byte (DC) required during the transfer */
+      /* Byte procedures without such a buffer report a larger burst size */
+      burst = u8x8_byte_GetMaxBurst(u8x8, 24);
       p = arg_ptr;
-       while( arg_int > 24 )
+       while( arg_int > burst )
       {
-	u8x8_i2c_data_transfer(u8x8, 24, p);
-	arg_int-=24;
-	p+=24;
+	u8x8_i2c_data_transfer(u8x8, burst, p);
+	arg_int-=burst;
+	p+=burst;
       }
       u8x8_i2c_data_transfer(u8x8, arg_int, p);
       in_transfer = 0;
@@ -0,0 +1,616 @@
+#include <album_art.h>
+#include <string.h>
+
+#define MARKER_SOF0 0xC0
+#define MARKER_SOF1 0xC1
+#define MARKER_DHT 0xC4
+#define MARKER_RST0 0xD0
+#define MARKER_RST7 0xD7
+#define MARKER_SOI 0xD8
+#define MARKER_EOI 0xD9
+#define MARKER_SOS 0xDA
+#define MARKER_DQT 0xDB
+#define MARKER_DRI 0xDD
+
+// Natural (row major) position of the n-th coefficient in zigzag order
+static const uint8_t ZIGZAG[64] = {
+    0, 1, 8, 16, 9, 2, 3, 10,
+    17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63};
+
+// IDCT basis: IDCT_TABLE[x][u] = 2048 * C(u) * cos((2x + 1) * u * pi / 16), C(0) = 1/sqrt(2)
+static const int16_t IDCT_TABLE[8][8] = {
+    {1448, 2009, 1892, 1703, 1448, 1138, 784, 400},
+    {1448, 1703, 784, -400, -1448, -2009, -1892, -1138},
+    {1448, 1138, -784, -2009, -1448, 400, 1892, 1703},
+    {1448, 400, -1892, -1138, 1448, 1703, -784, -2009},
+    {1448, -400, -1892, 1138, 1448, -1703, -784, 2009},
+    {1448, -1138, -784, 2009, -1448, -400, 1892, -1703},
+    {1448, -1703, 784, 400, -1448, 2009, -1892, 1138},
+    {1448, -2009, 1892, -1703, 1448, -1138, 784, -400}};
+
+// 8x8 Bayer matrix for the ordered dithering of the thumbnail
+static const uint8_t BAYER[8][8] = {
+    {0, 32, 8, 40, 2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44, 4, 36, 14, 46, 6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    {3, 35, 11, 43, 1, 33, 9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47, 7, 39, 13, 45, 5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21}};
+
+static int clamp(int value, int min, int max)
+{
+  return value < min ? min : (value > max ? max : value);
+}
+
+static int extend(int value, uint8_t bits)
+{
+  return value < (1 << (bits - 1)) ? value - (1 << bits) + 1 : value;
+}
+
+// Number of source samples which are merged into thumbnail pixel i
+static uint16_t span(uint16_t i, uint16_t source_size)
+{
+  uint32_t first = ((uint32_t)i * source_size + ALBUM_ART_SIZE - 1) / ALBUM_ART_SIZE;
+  uint32_t last = ((uint32_t)(i + 1) * source_size + ALBUM_ART_SIZE - 1) / ALBUM_ART_SIZE;
+  return last - first;
+}
+
+int AlbumArtDecoder::read_byte()
+{
+  if (_in_pos == _in_len)
+  {
+    _in_len = _eof ? 0 : _read(_ctx, _in_buf, sizeof(_in_buf));
+    _in_pos = 0;
+    if (_in_len == 0)
+    {
+      _eof = true;
+      return -1;
+    }
+  }
+  return _in_buf[_in_pos++];
+}
+
+bool AlbumArtDecoder::read_u16(uint16_t &value)
+{
+  int hi = read_byte();
+  int lo = read_byte();
+  value = (hi << 8) | lo;
+  return lo >= 0;
+}
+
+bool AlbumArtDecoder::skip(uint16_t len)
+{
+  while (len--)
+  {
+    if (read_byte() < 0)
+      return false;
+  }
+  return true;
+}
+
+bool AlbumArtDecoder::read_dqt()
+{
+  uint16_t len;
+  if (!read_u16(len) || len < 2)
+    return false;
+  len -= 2;
+  while (len > 0)
+  {
+    int pq_tq = read_byte();
+    if (pq_tq < 0)
+      return false;
+    bool wide = pq_tq >> 4;
+    uint16_t *table = _quant[pq_tq & 3];
+    for (int k = 0; k < 64; k++)
+    {
+      uint16_t value;
+      if (wide)
+      {
+        if (!read_u16(value))
+          return false;
+      }
+      else
+      {
+        int b = read_byte();
+        if (b < 0)
+          return false;
+        value = b;
+      }
+      table[k] = value;
+    }
+    uint16_t used = wide ? 129 : 65;
+    if (used > len)
+      return false;
+    len -= used;
+  }
+  return true;
+}
+
+bool AlbumArtDecoder::read_dht()
+{
+  uint16_t len;
+  if (!read_u16(len) || len < 2)
+    return false;
+  len -= 2;
+  while (len > 0)
+  {
+    int tc_th = read_byte();
+    if (tc_th < 0 || (tc_th & 0x0F) > 1 || (tc_th >> 4) > 1)
+      return false;
+    HuffmanTable &table = (tc_th >> 4) ? _ac_tables[tc_th & 1] : _dc_tables[tc_th & 1];
+
+    uint8_t counts[16];
+    uint16_t total = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      int b = read_byte();
+      if (b < 0)
+        return false;
+      counts[i] = b;
+      total += b;
+    }
+    if (total > sizeof(table.values) || 17 + total > len)
+      return false;
+    for (uint16_t i = 0; i < total; i++)
+    {
+      int b = read_byte();
+      if (b < 0)
+        return false;
+      table.values[i] = b;
+    }
+
+    // Canonical Huffman code construction (JPEG Annex F.2.2.3)
+    int32_t code = 0;
+    uint16_t k = 0;
+    for (int l = 1; l <= 16; l++)
+    {
+      table.valptr[l] = k;
+      table.mincode[l] = code;
+      code += counts[l - 1];
+      k += counts[l - 1];
+      table.maxcode[l] = counts[l - 1] ? code - 1 : -1;
+      code <<= 1;
+    }
+    table.defined = true;
+    len -= 17 + total;
+  }
+  return true;
+}
+
+bool AlbumArtDecoder::read_sof()
+{
+  uint16_t len;
+  if (!read_u16(len) || read_byte() != 8 || !read_u16(_height) || !read_u16(_width))
+    return false;
+  int count = read_byte();
+  if ((count != 1 && count != 3) || len != 8 + 3 * count)
+    return false;
+
+  _component_cnt = count;
+  _h_max = 1;
+  _v_max = 1;
+  for (int i = 0; i < count; i++)
+  {
+    Component &component = _components[i];
+    int id = read_byte();
+    int sampling = read_byte();
+    int tq = read_byte();
+    if (tq < 0)
+      return false;
+    component.id = id;
+    component.h = count == 1 ? 1 : sampling >> 4;
+    component.v = count == 1 ? 1 : sampling & 0x0F;
+    component.tq = tq & 3;
+    if (component.h < 1 || component.h > 2 || component.v < 1 || component.v > 2)
+      return false;
+    if (component.h > _h_max)
+      _h_max = component.h;
+    if (component.v > _v_max)
+      _v_max = component.v;
+  }
+
+  // The luminance is the only channel we reconstruct, so it has to be sampled at full resolution
+  if (_components[0].h != _h_max || _components[0].v != _v_max)
+    return false;
+
+  _scale = (_width / 8 >= ALBUM_ART_SIZE && _height / 8 >= ALBUM_ART_SIZE) ? 8 : 1;
+  _sample_width = (_width + _scale - 1) / _scale;
+  _sample_height = (_height + _scale - 1) / _scale;
+
+  // No upscaling and the accumulators of a thumbnail pixel have to fit into 16 bit
+  if (_sample_width < ALBUM_ART_SIZE || _sample_height < ALBUM_ART_SIZE)
+    return false;
+  uint32_t merged = (uint32_t)((_sample_width + ALBUM_ART_SIZE - 1) / ALBUM_ART_SIZE) *
+                    ((_sample_height + ALBUM_ART_SIZE - 1) / ALBUM_ART_SIZE);
+  return merged <= 257;
+}
+
+bool AlbumArtDecoder::read_dri()
+{
+  uint16_t len;
+  return read_u16(len) && len == 4 && read_u16(_restart_interval);
+}
+
+int AlbumArtDecoder::get_bit()
+{
+  if (_bit_cnt == 0)
+  {
+    int b = 0;
+    // After a marker was hit the scan is padded with zero bits
+    if (!_marker)
+    {
+      b = read_byte();
+      if (b == 0xFF)
+      {
+        int next;
+        do
+          next = read_byte();
+        while (next == 0xFF);
+
+        if (next != 0)
+        {
+          _marker = next < 0 ? MARKER_EOI : next;
+          b = 0;
+        }
+      }
+      else if (b < 0)
+      {
+        _marker = MARKER_EOI;
+        b = 0;
+      }
+    }
+    _bit_buf = b;
+    _bit_cnt = 8;
+  }
+  _bit_cnt--;
+  return (_bit_buf >> _bit_cnt) & 1;
+}
+
+int AlbumArtDecoder::get_bits(uint8_t n)
+{
+  int value = 0;
+  while (n--)
+    value = (value << 1) | get_bit();
+  return value;
+}
+
+int AlbumArtDecoder::decode_huffman(const HuffmanTable &table)
+{
+  int32_t code = 0;
+  for (int l = 1; l <= 16; l++)
+  {
+    code = (code << 1) | get_bit();
+    if (code <= table.maxcode[l])
+      return table.values[table.valptr[l] + code - table.mincode[l]];
+  }
+  return -1;
+}
+
+bool AlbumArtDecoder::restart()
+{
+  _bit_cnt = 0;
+  while (!_marker)
+  {
+    int b = read_byte();
+    if (b < 0)
+      return false;
+    if (b == 0xFF)
+    {
+      int next = read_byte();
+      if (next > 0 && next != 0xFF)
+        _marker = next;
+    }
+  }
+  if (_marker < MARKER_RST0 || _marker > MARKER_RST7)
+    return false;
+  _marker = 0;
+  for (int i = 0; i < _component_cnt; i++)
+    _components[i].dc_pred = 0;
+  return true;
+}
+
+bool AlbumArtDecoder::decode_block(Component &component, bool keep)
+{
+  int t = decode_huffman(_dc_tables[component.td]);
+  if (t < 0 || t > 11)
+    return false;
+  if (t)
+    component.dc_pred += extend(get_bits(t), t);
+
+  const uint16_t *quant = _quant[component.tq];
+  bool ac = keep && _scale == 1;
+  if (keep)
+  {
+    if (ac)
+      memset(_block, 0, sizeof(_block));
+    _block[0] = component.dc_pred * quant[0];
+  }
+
+  // The AC coefficients always have to be decoded to stay in sync with the bit stream
+  const HuffmanTable &table = _ac_tables[component.ta];
+  for (int k = 1; k < 64;)
+  {
+    int rs = decode_huffman(table);
+    if (rs < 0)
+      return false;
+    uint8_t r = rs >> 4;
+    uint8_t s = rs & 0x0F;
+    if (s == 0)
+    {
+      if (r != 15)
+        break;
+      k += 16;
+      continue;
+    }
+    k += r;
+    if (k > 63)
+      return false;
+    int value = extend(get_bits(s), s);
+    if (ac)
+      _block[ZIGZAG[k]] = clamp(value * quant[k], -2048, 2047);
+    k++;
+  }
+  return !_eof;
+}
+
+void AlbumArtDecoder::idct()
+{
+  int32_t tmp[64];
+
+  // Rows: the result keeps 3 fractional bits
+  for (int v = 0; v < 8; v++)
+  {
+    const int32_t *in = &_block[v * 8];
+    for (int x = 0; x < 8; x++)
+    {
+      int32_t sum = 0;
+      for (int u = 0; u < 8; u++)
+        sum += IDCT_TABLE[x][u] * in[u];
+      tmp[v * 8 + x] = (sum + 256) >> 9;
+    }
+  }
+
+  // Columns
+  for (int x = 0; x < 8; x++)
+  {
+    for (int y = 0; y < 8; y++)
+    {
+      int32_t sum = 0;
+      for (int v = 0; v < 8; v++)
+        sum += IDCT_TABLE[y][v] * tmp[v * 8 + x];
+      _block[y * 8 + x] = clamp(((sum + (1 << 14)) >> 15) + 128, 0, 255);
+    }
+  }
+}
+
+void AlbumArtDecoder::add_sample(uint16_t sx, uint16_t sy, int value)
+{
+  if (sx >= _sample_width || sy >= _sample_height)
+    return;
+  uint16_t tx = (uint32_t)sx * ALBUM_ART_SIZE / _sample_width;
+  uint16_t ty = (uint32_t)sy * ALBUM_ART_SIZE / _sample_height;
+  _band[ty % ALBUM_ART_BAND_ROWS][tx] += value;
+}
+
+void AlbumArtDecoder::put_block(uint16_t px, uint16_t py)
+{
+  int dc = clamp(((_block[0] + 4) >> 3) + 128, 0, 255);
+  if (_scale == 8)
+  {
+    add_sample(px >> 3, py >> 3, dc);
+    return;
+  }
+
+  bool flat = true;
+  for (int i = 1; i < 64 && flat; i++)
+    flat = _block[i] == 0;
+  if (!flat)
+    idct();
+
+  for (int y = 0; y < 8; y++)
+  {
+    for (int x = 0; x < 8; x++)
+      add_sample(px + x, py + y, flat ? dc : _block[y * 8 + x]);
+  }
+}
+
+void AlbumArtDecoder::flush_rows(uint16_t sample_rows_done)
+{
+  const uint8_t bytes_per_row = (ALBUM_ART_SIZE + 7) / 8;
+  uint16_t ready = (uint32_t)sample_rows_done * ALBUM_ART_SIZE / _sample_height;
+
+  for (; _next_row < ready; _next_row++)
+  {
+    uint16_t *sums = _band[_next_row % ALBUM_ART_BAND_ROWS];
+    uint16_t rows = span(_next_row, _sample_height);
+    uint8_t *out = &_out[_next_row * bytes_per_row];
+    for (uint16_t tx = 0; tx < ALBUM_ART_SIZE; tx++)
+    {
+      uint16_t gray = sums[tx] / (rows * span(tx, _sample_width));
+      if (gray > BAYER[_next_row & 7][tx & 7] * 4 + 2)
+        out[tx >> 3] |= 1 << (tx & 7);
+      sums[tx] = 0;
+    }
+  }
+}
+
+bool AlbumArtDecoder::read_sos()
+{
+  uint16_t len;
+  int count;
+  if (!read_u16(len) || (count = read_byte()) < 1 || count > _component_cnt || len != 6 + 2 * count)
+    return false;
+
+  Component *scan[3];
+  bool has_luma = false;
+  for (int i = 0; i < count; i++)
+  {
+    int id = read_byte();
+    int tables = read_byte();
+    scan[i] = nullptr;
+    for (int c = 0; c < _component_cnt; c++)
+    {
+      if (_components[c].id == id)
+        scan[i] = &_components[c];
+    }
+    if (!scan[i] || tables < 0)
+      return false;
+    scan[i]->td = (tables >> 4) & 1;
+    scan[i]->ta = tables & 1;
+    scan[i]->dc_pred = 0;
+    if (!_dc_tables[scan[i]->td].defined || !_ac_tables[scan[i]->ta].defined)
+      return false;
+    has_luma |= scan[i] == &_components[0];
+  }
+  // Spectral selection and successive approximation are fixed for baseline images
+  if (!skip(3))
+    return false;
+
+  if (!has_luma)
+  {
+    // Chroma only scan of a non interleaved image: skip until the next marker
+    _bit_cnt = 0;
+    while (!_marker)
+      get_bit();
+    return true;
+  }
+
+  uint32_t mcu = 0;
+  if (count == 1)
+  {
+    uint16_t blocks_x = (_width + 7) / 8;
+    uint16_t blocks_y = (_height + 7) / 8;
+    for (uint16_t by = 0; by < blocks_y; by++)
+    {
+      for (uint16_t bx = 0; bx < blocks_x; bx++, mcu++)
+      {
+        if (_restart_interval && mcu && mcu % _restart_interval == 0 && !restart())
+          return false;
+        if (!decode_block(*scan[0], true))
+          return false;
+        put_block(bx * 8, by * 8);
+      }
+      uint32_t done = (uint32_t)(by + 1) * 8 / _scale;
+      flush_rows(done > _sample_height ? _sample_height : done);
+    }
+  }
+  else
+  {
+    uint16_t mcu_w = 8 * _h_max;
+    uint16_t mcu_h = 8 * _v_max;
+    uint16_t mcus_x = (_width + mcu_w - 1) / mcu_w;
+    uint16_t mcus_y = (_height + mcu_h - 1) / mcu_h;
+    for (uint16_t my = 0; my < mcus_y; my++)
+    {
+      for (uint16_t mx = 0; mx < mcus_x; mx++, mcu++)
+      {
+        if (_restart_interval && mcu && mcu % _restart_interval == 0 && !restart())
+          return false;
+        for (int i = 0; i < count; i++)
+        {
+          Component &component = *scan[i];
+          bool luma = &component == &_components[0];
+          for (uint8_t v = 0; v < component.v; v++)
+          {
+            for (uint8_t h = 0; h < component.h; h++)
+            {
+              if (!decode_block(component, luma))
+                return false;
+              if (luma)
+                put_block(mx * mcu_w + h * 8, my * mcu_h + v * 8);
+            }
+          }
+        }
+      }
+      uint32_t done = (uint32_t)(my + 1) * mcu_h / _scale;
+      flush_rows(done > _sample_height ? _sample_height : done);
+    }
+  }
+  flush_rows(_sample_height);
+  _done = true;
+  return true;
+}
+
+bool AlbumArtDecoder::decode(album_art_read_cb read, void *ctx, uint8_t *xbm)
+{
+  _read = read;
+  _ctx = ctx;
+  _in_pos = 0;
+  _in_len = 0;
+  _eof = false;
+  _bit_cnt = 0;
+  _marker = 0;
+  _component_cnt = 0;
+  _restart_interval = 0;
+  _next_row = 0;
+  _dc_tables[0].defined = _dc_tables[1].defined = false;
+  _ac_tables[0].defined = _ac_tables[1].defined = false;
+  _done = false;
+  _out = xbm;
+  memset(_band, 0, sizeof(_band));
+  memset(xbm, 0, ALBUM_ART_BYTES);
+
+  if (read_byte() != 0xFF || read_byte() != MARKER_SOI)
+    return false;
+
+  // Only the first scan containing the luminance is needed, everything behind it is ignored
+  while (!_done)
+  {
+    int marker = _marker;
+    _marker = 0;
+    if (!marker)
+    {
+      int b;
+      do
+        b = read_byte();
+      while (b >= 0 && b != 0xFF);
+      do
+        marker = read_byte();
+      while (marker == 0xFF);
+      if (marker < 0)
+        return false;
+    }
+
+    bool ok = true;
+    uint16_t len;
+    switch (marker)
+    {
+    case MARKER_SOF0:
+    case MARKER_SOF1:
+      ok = read_sof();
+      break;
+    case MARKER_DHT:
+      ok = read_dht();
+      break;
+    case MARKER_DQT:
+      ok = read_dqt();
+      break;
+    case MARKER_DRI:
+      ok = read_dri();
+      break;
+    case MARKER_SOS:
+      ok = _component_cnt && read_sos();
+      break;
+    case MARKER_EOI:
+      return false;
+    default:
+      if (marker >= 0xC2 && marker <= 0xCF)
+        return false; // Progressive, lossless and arithmetic coded images are not supported
+      if ((marker >= MARKER_RST0 && marker <= MARKER_RST7) || marker == 0x01)
+        break;
+      ok = read_u16(len) && len >= 2 && skip(len - 2);
+      break;
+    }
+    if (!ok)
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,109 @@
+#ifndef ALBUM_ART_H
+#define ALBUM_ART_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Edge length of the square album cover thumbnail in pixels
+#define ALBUM_ART_SIZE 48
+// Size of a thumbnail in XBM format (rows of LSB first bytes, as consumed by drawXBM)
+#define ALBUM_ART_BYTES (((ALBUM_ART_SIZE + 7) / 8) * ALBUM_ART_SIZE)
+
+// Number of thumbnail rows which can be touched by a single MCU row (16 source lines + 1)
+#define ALBUM_ART_BAND_ROWS 17
+
+// Returns the number of bytes written to buf, 0 signals the end of the stream
+typedef size_t (*album_art_read_cb)(void *ctx, uint8_t *buf, size_t len);
+
+/*
+  Streaming decoder for baseline JPEG images which produces a dithered 1-bit thumbnail.
+
+  The image is never held in memory: the entropy coded data is decoded MCU by MCU,
+  only the luminance channel is reconstructed and every pixel is directly added to a small
+  band of accumulators of the thumbnail. Completed thumbnail rows are ordered dithered into the
+  XBM output. Images which are at least eight times larger than the thumbnail are decoded
+  with the DC coefficients only, which skips the IDCT completely.
+
+  The decoder needs about 4.5 KB of RAM, so it should live on the heap and not on the stack.
+*/
+class AlbumArtDecoder
+{
+private:
+  struct HuffmanTable
+  {
+    int32_t maxcode[17];
+    int32_t mincode[17];
+    uint16_t valptr[17];
+    uint8_t values[256];
+    bool defined;
+  };
+
+  struct Component
+  {
+    uint8_t id;
+    uint8_t h;
+    uint8_t v;
+    uint8_t tq;
+    uint8_t td;
+    uint8_t ta;
+    int dc_pred;
+  };
+
+  album_art_read_cb _read;
+  void *_ctx;
+
+  uint8_t _in_buf[128];
+  size_t _in_pos;
+  size_t _in_len;
+  bool _eof;
+
+  uint32_t _bit_buf;
+  uint8_t _bit_cnt;
+  uint8_t _marker;
+
+  uint16_t _quant[4][64];
+  HuffmanTable _dc_tables[2];
+  HuffmanTable _ac_tables[2];
+  Component _components[3];
+  uint8_t _component_cnt;
+  uint8_t _h_max;
+  uint8_t _v_max;
+  uint16_t _width;
+  uint16_t _height;
+  uint16_t _restart_interval;
+
+  // 1 = full IDCT, 8 = one sample per 8x8 block (DC only)
+  uint8_t _scale;
+  uint16_t _sample_width;
+  uint16_t _sample_height;
+  uint16_t _next_row;
+  uint16_t _band[ALBUM_ART_BAND_ROWS][ALBUM_ART_SIZE];
+  int32_t _block[64];
+  uint8_t *_out;
+  bool _done;
+
+  int read_byte();
+  bool read_u16(uint16_t &value);
+  bool skip(uint16_t len);
+  bool read_dqt();
+  bool read_dht();
+  bool read_sof();
+  bool read_dri();
+  bool read_sos();
+
+  int get_bit();
+  int get_bits(uint8_t n);
+  int decode_huffman(const HuffmanTable &table);
+  bool restart();
+  bool decode_block(Component &component, bool keep);
+  void idct();
+  void put_block(uint16_t sx, uint16_t sy);
+  void add_sample(uint16_t sx, uint16_t sy, int value);
+  void flush_rows(uint16_t sample_rows_done);
+
+public:
+  // Decodes the JPEG read through the callback and writes ALBUM_ART_BYTES to xbm
+  bool decode(album_art_read_cb read, void *ctx, uint8_t *xbm);
+};
+
+#endif
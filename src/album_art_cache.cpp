@@ -0,0 +1,119 @@
+#include <album_art_cache.h>
+#include <atomic_record.h>
+#include <checksum.h>
+#include <LittleFS.h>
+
+#define ALBUM_ART_CACHE_MAGIC 0x41414332 // "AAC2"
+
+uint32_t AlbumArtCache::make_key(const char *id)
+{
+  uint32_t key = fnv1a(id, strlen(id));
+  // 0 marks an empty slot
+  return key ? key : 1;
+}
+
+int AlbumArtCache::find(uint32_t key)
+{
+  for (int i = 0; i < ALBUM_ART_CACHE_SLOTS; i++)
+  {
+    if (_entries[i].key == key)
+      return i;
+  }
+  return -1;
+}
+
+void AlbumArtCache::begin()
+{
+  memset(_entries, 0, sizeof(_entries));
+  _clock = 0;
+  _ready = true;
+
+  // A missing, foreign or damaged index starts an empty cache, the slots are overwritten over time
+  AtomicRecord index(ALBUM_ART_CACHE_INDEX, ALBUM_ART_CACHE_MAGIC);
+  if (index.read(_entries, sizeof(_entries)) != sizeof(_entries))
+  {
+    memset(_entries, 0, sizeof(_entries));
+    return;
+  }
+  for (int i = 0; i < ALBUM_ART_CACHE_SLOTS; i++)
+  {
+    if (_entries[i].last_used > _clock)
+      _clock = _entries[i].last_used;
+  }
+}
+
+bool AlbumArtCache::write_index()
+{
+  return AtomicRecord(ALBUM_ART_CACHE_INDEX, ALBUM_ART_CACHE_MAGIC).write(_entries, sizeof(_entries));
+}
+
+bool AlbumArtCache::read_slot(int slot, char *id, uint8_t *xbm)
+{
+  File data = LittleFS.open(ALBUM_ART_CACHE_DATA, "r");
+  bool loaded = data &&
+                data.seek(slot * ALBUM_ART_CACHE_SLOT_BYTES, SeekSet) &&
+                data.read((uint8_t *)id, ALBUM_ART_CACHE_ID_SIZE) == ALBUM_ART_CACHE_ID_SIZE &&
+                data.read(xbm, ALBUM_ART_BYTES) == ALBUM_ART_BYTES &&
+                fnv1a(xbm, ALBUM_ART_BYTES, fnv1a(id, ALBUM_ART_CACHE_ID_SIZE)) == _entries[slot].checksum;
+  if (data)
+    data.close();
+  return loaded;
+}
+
+bool AlbumArtCache::get(const char *id, uint8_t *xbm)
+{
+  int slot = _ready ? find(make_key(id)) : -1;
+  if (slot < 0)
+    return false;
+
+  char stored_id[ALBUM_ART_CACHE_ID_SIZE];
+  if (!read_slot(slot, stored_id, xbm))
+  {
+    _entries[slot].key = 0;
+    return false;
+  }
+  // Another id with the same hash is a miss, the slot is replaced by the next put
+  stored_id[ALBUM_ART_CACHE_ID_SIZE - 1] = '\0';
+  if (strcmp(stored_id, id) != 0)
+    return false;
+  _entries[slot].last_used = ++_clock;
+  return true;
+}
+
+bool AlbumArtCache::put(const char *id, const uint8_t *xbm)
+{
+  size_t id_length = strlen(id);
+  if (!_ready || id_length >= ALBUM_ART_CACHE_ID_SIZE)
+    return false;
+
+  uint32_t key = make_key(id);
+  int slot = find(key);
+  if (slot < 0)
+  {
+    // Reuse an empty slot or evict the least recently used one
+    slot = 0;
+    for (int i = 0; i < ALBUM_ART_CACHE_SLOTS; i++)
+    {
+      if (_entries[i].key == 0 || _entries[i].last_used < _entries[slot].last_used)
+        slot = i;
+      if (_entries[i].key == 0)
+        break;
+    }
+  }
+
+  char padded_id[ALBUM_ART_CACHE_ID_SIZE] = {};
+  memcpy(padded_id, id, id_length);
+  File data = LittleFS.exists(ALBUM_ART_CACHE_DATA) ? LittleFS.open(ALBUM_ART_CACHE_DATA, "r+")
+                                                    : LittleFS.open(ALBUM_ART_CACHE_DATA, "w+");
+  if (!data)
+    return false;
+  bool written = data.seek(slot * ALBUM_ART_CACHE_SLOT_BYTES, SeekSet) &&
+                 data.write((const uint8_t *)padded_id, sizeof(padded_id)) == sizeof(padded_id) &&
+                 data.write(xbm, ALBUM_ART_BYTES) == ALBUM_ART_BYTES;
+  data.close();
+
+  _entries[slot].key = written ? key : 0;
+  _entries[slot].checksum = fnv1a(xbm, ALBUM_ART_BYTES, fnv1a(padded_id, sizeof(padded_id)));
+  _entries[slot].last_used = ++_clock;
+  return written && write_index();
+}
@@ -0,0 +1,52 @@
+#ifndef ALBUM_ART_CACHE_H
+#define ALBUM_ART_CACHE_H
+
+#include <Arduino.h>
+#include <album_art.h>
+
+// Number of thumbnails kept on flash, the data file takes ALBUM_ART_CACHE_SLOTS * ALBUM_ART_CACHE_SLOT_BYTES bytes
+#define ALBUM_ART_CACHE_SLOTS 64
+// Longest id (cover url) which is cached, including the terminating zero
+#define ALBUM_ART_CACHE_ID_SIZE 128
+// A slot holds the zero padded id followed by the thumbnail
+#define ALBUM_ART_CACHE_SLOT_BYTES (ALBUM_ART_CACHE_ID_SIZE + ALBUM_ART_BYTES)
+#define ALBUM_ART_CACHE_DATA "/art.bin"
+#define ALBUM_ART_CACHE_INDEX "/art.idx"
+
+/*
+  Flash backed LRU cache of decoded album art thumbnails.
+
+  All thumbnails live in fixed slots of a single data file, so the byte budget is fixed and
+  no LittleFS block is wasted per cover. The index (key, checksum and last use of every slot)
+  is kept in RAM and replaced atomically on flash through a temporary file and a rename.
+  The key is only a hash of the id, so every slot also stores the full id, which has to match on
+  a hit. A slot is only trusted while its data matches the checksum, an interrupted write is a miss.
+  Hits only update the LRU order in RAM, it is persisted with the next insert to spare the flash.
+*/
+class AlbumArtCache
+{
+private:
+  struct Entry
+  {
+    uint32_t key;
+    uint32_t checksum;
+    uint32_t last_used;
+  };
+
+  Entry _entries[ALBUM_ART_CACHE_SLOTS];
+  uint32_t _clock;
+  bool _ready;
+
+  static uint32_t make_key(const char *id);
+  int find(uint32_t key);
+  bool write_index();
+  bool read_slot(int slot, char *id, uint8_t *xbm);
+
+public:
+  // Loads the index, LittleFS has to be mounted before
+  void begin();
+  bool get(const char *id, uint8_t *xbm);
+  bool put(const char *id, const uint8_t *xbm);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include <atomic_record.h>
+#include <checksum.h>
+#include <LittleFS.h>
+
+size_t AtomicRecord::read(void *data, size_t capacity)
+{
+  File file = LittleFS.open(_path, "r");
+  if (!file)
+    return 0;
+
+  uint32_t magic = 0;
+  uint16_t size = 0;
+  uint32_t checksum = 0;
+  bool valid = file.read((uint8_t *)&magic, sizeof(magic)) == sizeof(magic) &&
+               magic == _magic &&
+               file.read((uint8_t *)&size, sizeof(size)) == sizeof(size) &&
+               size > 0 && size <= capacity &&
+               file.read((uint8_t *)data, size) == size &&
+               file.read((uint8_t *)&checksum, sizeof(checksum)) == sizeof(checksum) &&
+               checksum == fnv1a(data, size);
+  file.close();
+  return valid ? size : 0;
+}
+
+bool AtomicRecord::write(const void *data, size_t size)
+{
+  char tmp_path[ATOMIC_RECORD_PATH_SIZE];
+  if (size == 0 || size > ATOMIC_RECORD_MAX_SIZE ||
+      snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", _path) >= (int)sizeof(tmp_path))
+    return false;
+
+  File tmp = LittleFS.open(tmp_path, "w");
+  if (!tmp)
+    return false;
+
+  uint32_t magic = _magic;
+  uint16_t stored_size = size;
+  uint32_t checksum = fnv1a(data, size);
+  bool written = tmp.write((const uint8_t *)&magic, sizeof(magic)) == sizeof(magic) &&
+                 tmp.write((const uint8_t *)&stored_size, sizeof(stored_size)) == sizeof(stored_size) &&
+                 tmp.write((const uint8_t *)data, size) == size &&
+                 tmp.write((const uint8_t *)&checksum, sizeof(checksum)) == sizeof(checksum);
+  tmp.close();
+
+  // The rename replaces the old record atomically, so a power loss never leaves half a record
+  return written && LittleFS.rename(tmp_path, _path);
+}
+
+bool AtomicRecord::remove()
+{
+  return LittleFS.remove(_path);
+}
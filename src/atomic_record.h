@@ -0,0 +1,35 @@
+#ifndef ATOMIC_RECORD_H
+#define ATOMIC_RECORD_H
+
+#include <Arduino.h>
+
+// Largest payload of a record, its size is stored in 16 bits
+#define ATOMIC_RECORD_MAX_SIZE 0xFFFF
+// Room for the path of the temporary file, the record path plus ".tmp"
+#define ATOMIC_RECORD_PATH_SIZE 32
+
+/*
+  A payload on flash which is replaced atomically.
+
+  The file holds a magic number, the size of the payload, the payload and its FNV-1a checksum.
+  A new payload is written to a temporary file first, which then replaces the record with a rename,
+  so a power loss leaves either the old or the new record. A record with another magic number,
+  e.g. of an older layout, or a payload which does not match the checksum is never loaded.
+*/
+class AtomicRecord
+{
+private:
+  const char *_path;
+  uint32_t _magic;
+
+public:
+  AtomicRecord(const char *path, uint32_t magic) : _path(path), _magic(magic) {}
+
+  // Returns the size of the payload read into data, 0 if there is no valid record of at most capacity bytes.
+  // data is undefined then.
+  size_t read(void *data, size_t capacity);
+  bool write(const void *data, size_t size);
+  bool remove();
+};
+
+#endif
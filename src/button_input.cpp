@@ -0,0 +1,212 @@
+#include <button_input.h>
+
+ButtonInput *ButtonInput::_instance = nullptr;
+
+template <uint8_t N>
+void IRAM_ATTR ButtonInput::on_edge()
+{
+  _instance->push_edge(N);
+}
+
+void IRAM_ATTR ButtonInput::push_edge(uint8_t button)
+{
+  if (_edge_hook)
+    _edge_hook();
+  uint8_t head = _edge_head;
+  uint8_t next = (head + 1) & (BUTTON_EDGE_QUEUE_SIZE - 1);
+  if (next == _edge_tail)
+  {
+    _dropped_edges = _dropped_edges + 1;
+    return;
+  }
+  _edges[head].button = button;
+  _edges[head].level = digitalRead(_buttons[button].pin);
+  _edges[head].timestamp = micros();
+  // Publish the slot only after it is completely written
+  _edge_head = next;
+}
+
+void ButtonInput::begin(const uint8_t (&pins)[BUTTON_COUNT], const uint8_t (&gestures)[BUTTON_COUNT])
+{
+  static void (*const handlers[BUTTON_COUNT])() = {on_edge<0>, on_edge<1>};
+
+  _instance = this;
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+  {
+    Button &button = _buttons[i];
+    memset(&button, 0, sizeof(button));
+    button.pin = pins[i];
+    button.gestures = gestures[i];
+    button.state = IDLE;
+    pinMode(button.pin, INPUT);
+    button.level = digitalRead(button.pin);
+    attachInterrupt(digitalPinToInterrupt(button.pin), handlers[i], CHANGE);
+  }
+}
+
+void ButtonInput::emit(uint8_t button, ButtonEventType type, uint32_t timestamp)
+{
+  uint8_t next = (_event_head + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+  if (next == _event_tail)
+    return;
+  _events[_event_head] = {button, type, timestamp};
+  _event_head = next;
+}
+
+void ButtonInput::debounced_press(Button &button, uint8_t index)
+{
+  button.state = PRESSED;
+  button.pressed_at = button.since;
+  button.reported = false;
+  if (button.press_pending && button.since - button.pending_at <= BUTTON_DOUBLE_PRESS_MS * 1000UL)
+  {
+    button.press_pending = false;
+    button.reported = true;
+    emit(index, BUTTON_DOUBLE_PRESS, button.since);
+  }
+  else if (!button.gestures)
+  {
+    button.reported = true;
+    emit(index, BUTTON_PRESS, button.since);
+  }
+}
+
+void ButtonInput::debounced_release(Button &button, uint8_t index)
+{
+  button.state = IDLE;
+  if (button.reported)
+    return;
+  // A short press is a plain press unless a second one may still follow
+  if (button.gestures & BUTTON_GESTURE_DOUBLE)
+  {
+    button.press_pending = true;
+    button.pending_at = button.pressed_at;
+  }
+  else
+    emit(index, BUTTON_PRESS, button.since);
+}
+
+void ButtonInput::advance(Button &button, uint8_t index, uint32_t now)
+{
+  switch (button.state)
+  {
+  case IDLE:
+    if (button.press_pending && now - button.pending_at > BUTTON_DOUBLE_PRESS_MS * 1000UL)
+    {
+      button.press_pending = false;
+      emit(index, BUTTON_PRESS, button.pending_at + BUTTON_DOUBLE_PRESS_MS * 1000UL);
+    }
+    break;
+  case DEBOUNCE_DOWN:
+    if (now - button.since < BUTTON_DEBOUNCE_MS * 1000UL)
+      break;
+    debounced_press(button, index);
+    // A long press may already be over when the edges are replayed late
+    advance(button, index, now);
+    break;
+  case PRESSED:
+    if (!button.reported && (button.gestures & BUTTON_GESTURE_LONG) &&
+        now - button.pressed_at >= BUTTON_LONG_PRESS_MS * 1000UL)
+    {
+      button.state = LONG_HELD;
+      button.reported = true;
+      emit(index, BUTTON_LONG_PRESS, button.pressed_at + BUTTON_LONG_PRESS_MS * 1000UL);
+    }
+    break;
+  case DEBOUNCE_UP:
+    if (now - button.since < BUTTON_DEBOUNCE_MS * 1000UL)
+      break;
+    debounced_release(button, index);
+    // The double press window may already be over as well
+    advance(button, index, now);
+    break;
+  default:
+    break;
+  }
+}
+
+void ButtonInput::apply_edge(Button &button, uint8_t level, uint32_t timestamp)
+{
+  button.level = level;
+  switch (button.state)
+  {
+  case IDLE:
+  case DEBOUNCE_DOWN:
+    // Every bounce restarts the debounce time
+    button.state = level ? DEBOUNCE_DOWN : IDLE;
+    button.since = timestamp;
+    break;
+  case PRESSED:
+  case LONG_HELD:
+    if (!level)
+    {
+      button.held_state = button.state;
+      button.state = DEBOUNCE_UP;
+      button.since = timestamp;
+    }
+    break;
+  case DEBOUNCE_UP:
+    if (level)
+      button.state = button.held_state;
+    else
+      button.since = timestamp;
+    break;
+  }
+}
+
+bool ButtonInput::poll(ButtonEvent &event)
+{
+  if (_event_tail == _event_head)
+  {
+    while (_edge_tail != _edge_head)
+    {
+      const Edge &edge = _edges[_edge_tail];
+      Button &button = _buttons[edge.button];
+      advance(button, edge.button, edge.timestamp);
+      apply_edge(button, edge.level, edge.timestamp);
+      _edge_tail = (_edge_tail + 1) & (BUTTON_EDGE_QUEUE_SIZE - 1);
+    }
+
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+      advance(_buttons[i], i, now);
+  }
+
+  if (_event_tail == _event_head)
+    return false;
+  event = _events[_event_tail];
+  _event_tail = (_event_tail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+  return true;
+}
+
+uint32_t ButtonInput::record_latency(const ButtonEvent &event, uint32_t shown_at)
+{
+  uint32_t latency = shown_at - event.timestamp;
+  _latency_count++;
+  _latency_total += latency;
+  if (latency > _latency_max)
+    _latency_max = latency;
+  return latency;
+}
+
+bool ButtonInput::is_busy()
+{
+  if (_edge_tail != _edge_head || _event_tail != _event_head)
+    return true;
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+  {
+    // A released button only waits for the next press, unless its press waits for a double press
+    if (_buttons[i].state != IDLE || _buttons[i].press_pending)
+      return true;
+  }
+  return false;
+}
+
+bool ButtonInput::get_pending_edge(uint32_t &timestamp)
+{
+  uint8_t tail = _edge_tail;
+  if (tail == _edge_head)
+    return false;
+  timestamp = _edges[tail].timestamp;
+  return true;
+}
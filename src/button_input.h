@@ -0,0 +1,140 @@
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <Arduino.h>
+
+#define BUTTON_COUNT 2
+// Both queues must have a power of two size
+#define BUTTON_EDGE_QUEUE_SIZE 32
+#define BUTTON_EVENT_QUEUE_SIZE 8
+
+#define BUTTON_DEBOUNCE_MS 20
+#define BUTTON_LONG_PRESS_MS 600
+#define BUTTON_DOUBLE_PRESS_MS 350
+
+// Gestures a button can report besides a plain press, a button without any reports the press at once
+#define BUTTON_GESTURE_LONG 1
+#define BUTTON_GESTURE_DOUBLE 2
+
+enum ButtonEventType
+{
+  BUTTON_PRESS,
+  BUTTON_LONG_PRESS,
+  BUTTON_DOUBLE_PRESS
+};
+
+struct ButtonEvent
+{
+  uint8_t button;
+  ButtonEventType type;
+  // micros() of the edge which decided the event, the long press threshold or the end of the double press window
+  uint32_t timestamp;
+};
+
+/*
+  Button input driven by GPIO interrupts.
+
+  The interrupt handlers only timestamp every edge into a lock free single producer ring
+  buffer, so presses during blocking network calls are not lost. poll() replays the edges
+  through a debounce state machine per button, the states follow u8x8_debounce.c:
+
+    IDLE           released and stable
+    DEBOUNCE_DOWN  pressed edge seen, waiting BUTTON_DEBOUNCE_MS (State B + cnt)
+    PRESSED        keypress detected (State C)
+    LONG_HELD      held longer than BUTTON_LONG_PRESS_MS, long press reported
+    DEBOUNCE_UP    released edge seen, waiting BUTTON_DEBOUNCE_MS
+
+  Every press yields exactly one event. A button without gestures reports the press as soon as
+  it is debounced. With a long press gesture the press is only reported on the release before
+  BUTTON_LONG_PRESS_MS, with a double press gesture only once BUTTON_DOUBLE_PRESS_MS passed
+  without a second press, which is reported as double press instead.
+
+  Every transition uses the timestamps of the edges and not the time of the poll, so a late
+  poll() still yields the same events. A held button is reported once and never repeats.
+*/
+class ButtonInput
+{
+private:
+  enum State
+  {
+    IDLE,
+    DEBOUNCE_DOWN,
+    PRESSED,
+    LONG_HELD,
+    DEBOUNCE_UP
+  };
+
+  struct Edge
+  {
+    uint8_t button;
+    uint8_t level;
+    uint32_t timestamp;
+  };
+
+  struct Button
+  {
+    uint8_t pin;
+    State state;
+    // State before DEBOUNCE_UP, a bouncing release returns to it
+    State held_state;
+    uint8_t level;
+    uint8_t gestures;
+    uint32_t since;
+    uint32_t pressed_at;
+    // The current press already yielded its event
+    bool reported;
+    // A released press waits for the double press window, it started at pending_at
+    bool press_pending;
+    uint32_t pending_at;
+  };
+
+  static ButtonInput *_instance;
+
+  Button _buttons[BUTTON_COUNT];
+  Edge _edges[BUTTON_EDGE_QUEUE_SIZE];
+  volatile uint8_t _edge_head = 0;
+  volatile uint8_t _edge_tail = 0;
+  volatile uint32_t _dropped_edges = 0;
+  void (*_edge_hook)() = nullptr;
+
+  ButtonEvent _events[BUTTON_EVENT_QUEUE_SIZE];
+  uint8_t _event_head = 0;
+  uint8_t _event_tail = 0;
+
+  uint32_t _latency_count = 0;
+  uint32_t _latency_total = 0;
+  uint32_t _latency_max = 0;
+
+  template <uint8_t N>
+  static void on_edge();
+  void push_edge(uint8_t button);
+
+  void emit(uint8_t button, ButtonEventType type, uint32_t timestamp);
+  void debounced_press(Button &button, uint8_t index);
+  void debounced_release(Button &button, uint8_t index);
+  void advance(Button &button, uint8_t index, uint32_t now);
+  void apply_edge(Button &button, uint8_t level, uint32_t timestamp);
+
+public:
+  // Pins are active high, the index of a pin is reported as ButtonEvent::button.
+  // gestures holds the BUTTON_GESTURE_ flags of every button.
+  void begin(const uint8_t (&pins)[BUTTON_COUNT], const uint8_t (&gestures)[BUTTON_COUNT]);
+  bool poll(ButtonEvent &event);
+
+  // Tracks the time from the edge to the pixels, shown_at is the micros() the reaction was on the panel
+  uint32_t record_latency(const ButtonEvent &event, uint32_t shown_at);
+  uint32_t get_average_latency() { return _latency_count ? _latency_total / _latency_count : 0; }
+  uint32_t get_max_latency() { return _latency_max; }
+  uint32_t get_dropped_edges() { return _dropped_edges; }
+
+  // True while a press is debounced, held or waits for a double press, poll() then has to run again
+  // within BUTTON_DEBOUNCE_MS
+  bool is_busy();
+  // Timestamp of the oldest edge which was not polled yet
+  bool get_pending_edge(uint32_t &timestamp);
+  uint8_t get_pin(uint8_t button) { return _buttons[button].pin; }
+  // Runs in the interrupt handler on every edge, before it is queued. The hook must be in IRAM
+  void set_edge_hook(void (*hook)()) { _edge_hook = hook; }
+};
+
+#endif
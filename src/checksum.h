@@ -0,0 +1,21 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FNV1A_INIT 2166136261u
+
+// 32 bit FNV-1a hash, used as key and integrity check for everything stored on flash
+inline uint32_t fnv1a(const void *data, size_t len, uint32_t hash = FNV1A_INIT)
+{
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  while (len--)
+  {
+    hash ^= *bytes++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+#endif
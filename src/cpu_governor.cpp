@@ -0,0 +1,81 @@
+#include "cpu_governor.h"
+
+extern "C"
+{
+#include <user_interface.h>
+}
+
+// Adds the time since the last switch to the current frequency
+void CpuGovernor::account()
+{
+  uint32_t now = micros();
+  uint32_t elapsed = now - _switched_at;
+  _switched_at = now;
+  if (_boosts)
+    _boost_us += elapsed;
+  else
+    _idle_us += elapsed;
+}
+
+void CpuGovernor::set_frequency(uint8_t mhz)
+{
+  if (system_get_cpu_freq() != mhz)
+    system_update_cpu_freq(mhz);
+}
+
+void CpuGovernor::begin()
+{
+  _boosts = 0;
+  _switched_at = micros();
+  _logged_at = millis();
+  set_frequency(CPU_GOVERNOR_IDLE_MHZ);
+}
+
+void CpuGovernor::boost()
+{
+  if (_boosts == 0)
+  {
+    account();
+    _boost_cnt++;
+    set_frequency(CPU_GOVERNOR_BOOST_MHZ);
+  }
+  _boosts++;
+}
+
+void CpuGovernor::release()
+{
+  if (_boosts == 0)
+    return;
+  if (_boosts == 1)
+  {
+    account();
+    set_frequency(CPU_GOVERNOR_IDLE_MHZ);
+  }
+  _boosts--;
+
+  if (_boosts == 0 && millis() - _logged_at >= CPU_GOVERNOR_LOG_INTERVAL)
+    log();
+}
+
+uint32_t CpuGovernor::get_idle_ms()
+{
+  account();
+  return _idle_us / 1000;
+}
+
+uint32_t CpuGovernor::get_boost_ms()
+{
+  account();
+  return _boost_us / 1000;
+}
+
+void CpuGovernor::log()
+{
+  _logged_at = millis();
+  uint32_t boost_ms = get_boost_ms();
+  uint32_t idle_ms = get_idle_ms();
+  uint32_t total_ms = boost_ms + idle_ms;
+  Serial.printf("Cpu: %u MHz for %lu ms (%lu%%), %u MHz for %lu ms, %lu boosts\n", CPU_GOVERNOR_BOOST_MHZ,
+                (unsigned long)boost_ms, (unsigned long)(total_ms ? (uint64_t)boost_ms * 100 / total_ms : 0),
+                CPU_GOVERNOR_IDLE_MHZ, (unsigned long)idle_ms, (unsigned long)_boost_cnt);
+}
@@ -0,0 +1,56 @@
+#ifndef CPU_GOVERNOR_H
+#define CPU_GOVERNOR_H
+
+#include <Arduino.h>
+
+#define CPU_GOVERNOR_IDLE_MHZ 80
+#define CPU_GOVERNOR_BOOST_MHZ 160
+// The time per frequency is logged at most once per interval, after a boost ended
+#define CPU_GOVERNOR_LOG_INTERVAL 60000
+
+/*
+  Runs the CPU at 80 MHz and raises it to 160 MHz while a CPU bound job is running.
+
+  TLS handshakes, decrypting and parsing responses, decoding album art and rendering frames are
+  wrapped in a CpuBoost, the rest of the loop mostly waits for the network and buttons at the low
+  clock. Boosts nest, the clock drops once the outermost one ends. The time spent at each
+  frequency is accumulated, so latency can be traded against heat and power consumption.
+
+  Code which counts CPU cycles has to check CPU2X, the cycle counter runs at the CPU clock.
+*/
+class CpuGovernor
+{
+private:
+  uint8_t _boosts = 0;
+  uint32_t _switched_at = 0;
+  uint64_t _idle_us = 0;
+  uint64_t _boost_us = 0;
+  uint32_t _boost_cnt = 0;
+  unsigned long _logged_at = 0;
+
+  void account();
+  void set_frequency(uint8_t mhz);
+
+public:
+  void begin();
+  void boost();
+  void release();
+  bool is_boosted() { return _boosts > 0; }
+  uint32_t get_idle_ms();
+  uint32_t get_boost_ms();
+  uint32_t get_boost_count() { return _boost_cnt; }
+  void log();
+};
+
+// Keeps the CPU boosted for the lifetime of the object
+class CpuBoost
+{
+private:
+  CpuGovernor &_governor;
+
+public:
+  CpuBoost(CpuGovernor &governor) : _governor(governor) { _governor.boost(); }
+  ~CpuBoost() { _governor.release(); }
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include <display_list.h>
+
+// Rows are kept in a byte, which covers the 64 pixel high panel
+#define DISPLAY_LIST_ROWS 8
+
+static uint8_t row_mask(int top, int bottom)
+{
+  if (bottom < 0 || top >= DISPLAY_LIST_ROWS * 8 || bottom < top)
+    return 0;
+  if (top < 0)
+    top = 0;
+  if (bottom >= DISPLAY_LIST_ROWS * 8)
+    bottom = DISPLAY_LIST_ROWS * 8 - 1;
+
+  uint8_t first = top / 8;
+  uint8_t last = bottom / 8;
+  return (uint8_t)((0xFF << first) & (0xFF >> (DISPLAY_LIST_ROWS - 1 - last)));
+}
+
+DisplayCommand *DisplayList::add(DisplayCommandType type, int top, int bottom)
+{
+  if (_count >= DISPLAY_LIST_SIZE)
+    return nullptr;
+  DisplayCommand *command = &_commands[_count++];
+  command->type = type;
+  command->rows = row_mask(top, bottom);
+  command->data = nullptr;
+  return command;
+}
+
+bool DisplayList::draw_utf8(U8G2 &display, int x, int y, const char *text)
+{
+  // Glyphs reach from the ascent above the baseline down to the descent of the font
+  int8_t y_offset = display.getU8g2()->font_info.y_offset;
+  int top = y - display.getMaxCharHeight() - y_offset;
+  DisplayCommand *command = add(DISPLAY_DRAW_UTF8, top, y - y_offset - 1);
+  if (!command)
+    return false;
+  command->args[0] = x;
+  command->args[1] = y;
+  command->data = text;
+  return true;
+}
+
+bool DisplayList::draw_box(int x, int y, int w, int h)
+{
+  DisplayCommand *command = add(DISPLAY_DRAW_BOX, y, y + h - 1);
+  if (!command)
+    return false;
+  command->args[0] = x;
+  command->args[1] = y;
+  command->args[2] = w;
+  command->args[3] = h;
+  return true;
+}
+
+bool DisplayList::draw_triangle(int x0, int y0, int x1, int y1, int x2, int y2)
+{
+  DisplayCommand *command = add(DISPLAY_DRAW_TRIANGLE, min(y0, min(y1, y2)), max(y0, max(y1, y2)));
+  if (!command)
+    return false;
+  command->args[0] = x0;
+  command->args[1] = y0;
+  command->args[2] = x1;
+  command->args[3] = y1;
+  command->args[4] = x2;
+  command->args[5] = y2;
+  return true;
+}
+
+bool DisplayList::draw_xbm(int x, int y, int w, int h, const uint8_t *bitmap)
+{
+  DisplayCommand *command = add(DISPLAY_DRAW_XBM, y, y + h - 1);
+  if (!command)
+    return false;
+  command->args[0] = x;
+  command->args[1] = y;
+  command->args[2] = w;
+  command->args[3] = h;
+  command->data = bitmap;
+  return true;
+}
+
+bool DisplayList::set_clip_window(int x0, int y0, int x1, int y1)
+{
+  DisplayCommand *command = add(DISPLAY_SET_CLIP_WINDOW, 0, DISPLAY_LIST_ROWS * 8 - 1);
+  if (!command)
+    return false;
+  command->args[0] = x0;
+  command->args[1] = y0;
+  command->args[2] = x1;
+  command->args[3] = y1;
+  return true;
+}
+
+bool DisplayList::set_max_clip_window()
+{
+  return add(DISPLAY_SET_MAX_CLIP_WINDOW, 0, DISPLAY_LIST_ROWS * 8 - 1) != nullptr;
+}
+
+void DisplayList::replay(U8G2 &display)
+{
+  uint8_t row = display.getBufferCurrTileRow();
+  uint8_t page = row_mask(row * 8, (row + display.getBufferTileHeight()) * 8 - 1);
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    const DisplayCommand &command = _commands[i];
+    if (!(command.rows & page))
+      continue;
+
+    const int16_t *args = command.args;
+    switch (command.type)
+    {
+    case DISPLAY_DRAW_UTF8:
+      display.drawUTF8(args[0], args[1], (const char *)command.data);
+      break;
+    case DISPLAY_DRAW_BOX:
+      display.drawBox(args[0], args[1], args[2], args[3]);
+      break;
+    case DISPLAY_DRAW_TRIANGLE:
+      display.drawTriangle(args[0], args[1], args[2], args[3], args[4], args[5]);
+      break;
+    case DISPLAY_DRAW_XBM:
+      display.drawXBM(args[0], args[1], args[2], args[3], (const uint8_t *)command.data);
+      break;
+    case DISPLAY_SET_CLIP_WINDOW:
+      display.setClipWindow(args[0], args[1], args[2], args[3]);
+      break;
+    case DISPLAY_SET_MAX_CLIP_WINDOW:
+      display.setMaxClipWindow();
+      break;
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Maximum number of recorded draw calls
+#define DISPLAY_LIST_SIZE 12
+
+enum DisplayCommandType : uint8_t
+{
+  DISPLAY_DRAW_UTF8,
+  DISPLAY_DRAW_BOX,
+  DISPLAY_DRAW_TRIANGLE,
+  DISPLAY_DRAW_XBM,
+  DISPLAY_SET_CLIP_WINDOW,
+  DISPLAY_SET_MAX_CLIP_WINDOW
+};
+
+struct DisplayCommand
+{
+  DisplayCommandType type;
+  // Bit n is set if the bounding box touches tile row n
+  uint8_t rows;
+  int16_t args[6];
+  const void *data;
+};
+
+/*
+  Recorded list of draw calls for the page buffer.
+
+  In page mode the picture loop runs once per tile row and every draw call is clipped against the
+  current page again. The list is recorded once per frame, each command is binned into the tile rows
+  its bounding box touches and replay() only executes the commands of the current page. Clip window
+  changes are state and are replayed on every page.
+
+  Strings and bitmaps are referenced, not copied, so they have to outlive the list.
+*/
+class DisplayList
+{
+private:
+  DisplayCommand _commands[DISPLAY_LIST_SIZE];
+  uint8_t _count = 0;
+
+  DisplayCommand *add(DisplayCommandType type, int top, int bottom);
+
+public:
+  void clear() { _count = 0; }
+  uint8_t get_count() { return _count; }
+
+  // The current font of the display is used for the bounding box of the text
+  bool draw_utf8(U8G2 &display, int x, int y, const char *text);
+  bool draw_box(int x, int y, int w, int h);
+  bool draw_triangle(int x0, int y0, int x1, int y1, int x2, int y2);
+  bool draw_xbm(int x, int y, int w, int h, const uint8_t *bitmap);
+  bool set_clip_window(int x0, int y0, int x1, int y1);
+  bool set_max_clip_window();
+
+  // Executes the commands which intersect the current page, call inside the picture loop
+  void replay(U8G2 &display);
+};
+
+#endif
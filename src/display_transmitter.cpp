@@ -0,0 +1,281 @@
+#include <display_transmitter.h>
+#include <virtual_sh1106.h>
+
+// Flags of a queue entry, the low byte is the byte on the bus
+#define DISPLAY_TX_START 0x100
+#define DISPLAY_TX_STOP 0x200
+
+// timer1 runs with 5 ticks per microsecond with TIM_DIV16
+#define DISPLAY_TX_TICKS (DISPLAY_TX_TICK_PERIOD_US * 5)
+// Cycles at 80 MHz, doubled while the CPU runs at 160 MHz
+#define DISPLAY_TX_EDGE_GAP_CYCLES (DISPLAY_TX_EDGE_GAP_NS * 80 / 1000)
+#define DISPLAY_TX_CYCLES_PER_MS 80000
+// A start takes SCL low, releases SDA and SCL and then pulls SDA low
+#define DISPLAY_TX_START_EDGES 4
+
+DisplayTransmitter *DisplayTransmitter::_instance = nullptr;
+
+void DisplayTransmitter::begin(U8G2 &display)
+{
+  _instance = this;
+  display.getU8x8()->byte_cb = byte_cb;
+}
+
+void DisplayTransmitter::mark()
+{
+  noInterrupts();
+  _mark = _transfers_queued;
+  _mark_sent = _transfers_sent == _mark;
+  if (_mark_sent)
+    _marked_at = micros();
+  interrupts();
+}
+
+void DisplayTransmitter::flush()
+{
+  while (!is_idle())
+    yield();
+}
+
+void DisplayTransmitter::init_pins(uint8_t scl, uint8_t sda)
+{
+  _scl_mask = 1UL << scl;
+  _sda_mask = 1UL << sda;
+  pinMode(scl, INPUT_PULLUP);
+  pinMode(sda, INPUT_PULLUP);
+  // The output latch stays low, enabling the output pulls the line down
+  GPOC = _scl_mask | _sda_mask;
+  GPEC = _scl_mask | _sda_mask;
+
+  timer1_attachInterrupt(on_timer);
+  timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+}
+
+void DisplayTransmitter::push(uint16_t entry)
+{
+  uint16_t head = _head;
+  uint16_t next = (head + 1) & (DISPLAY_TX_QUEUE_SIZE - 1);
+  if (next == _tail)
+  {
+    _stalls++;
+    while (next == _tail)
+      yield();
+  }
+  _queue[head] = entry;
+
+  // The interrupt clears _running when it finds the queue empty, it must not run in between
+  noInterrupts();
+  _head = next;
+  if (!_running)
+  {
+    _running = true;
+    timer1_write(DISPLAY_TX_TICKS);
+  }
+  interrupts();
+}
+
+uint8_t DisplayTransmitter::byte_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  uint8_t *data;
+  VirtualSH1106 *monitor = _instance->_monitor;
+
+  switch (msg)
+  {
+  case U8X8_MSG_BYTE_SEND:
+    data = (uint8_t *)arg_ptr;
+    while (arg_int > 0)
+    {
+      if (monitor)
+        monitor->on_byte(*data);
+      _instance->push(*data);
+      data++;
+      arg_int--;
+    }
+    break;
+  case U8X8_MSG_BYTE_INIT:
+    _instance->init_pins(u8x8->pins[U8X8_PIN_I2C_CLOCK], u8x8->pins[U8X8_PIN_I2C_DATA]);
+    break;
+  case U8X8_MSG_BYTE_SET_DC:
+    break;
+  case U8X8_MSG_BYTE_START_TRANSFER:
+    if (monitor)
+    {
+      monitor->on_start();
+      monitor->on_byte(u8x8_GetI2CAddress(u8x8));
+    }
+    _instance->push(DISPLAY_TX_START | u8x8_GetI2CAddress(u8x8));
+    break;
+  case U8X8_MSG_BYTE_END_TRANSFER:
+    if (monitor)
+      monitor->on_stop();
+    _instance->push(DISPLAY_TX_STOP);
+    _instance->_transfers_queued++;
+    break;
+  case U8X8_MSG_BYTE_GET_MAX_BURST:
+    // The queue has no limit per transfer
+    *(uint8_t *)arg_ptr = 255;
+    break;
+  default:
+    return 0;
+  }
+  return 1;
+}
+
+void IRAM_ATTR DisplayTransmitter::on_timer()
+{
+  _instance->transmit();
+}
+
+void IRAM_ATTR DisplayTransmitter::transmit()
+{
+  uint32_t started = esp_get_cycle_count();
+  uint8_t cpu2x = CPU2X & 1;
+  uint32_t gap = DISPLAY_TX_EDGE_GAP_CYCLES << cpu2x;
+  uint32_t edge_at = started;
+  bool pending = _edge != 0 || _tail != _head;
+  for (uint8_t edges = 0; pending && edges < DISPLAY_TX_EDGES_PER_TICK; edges++)
+  {
+    if (edges)
+    {
+      while (esp_get_cycle_count() - edge_at < gap)
+        ;
+      edge_at = esp_get_cycle_count();
+    }
+    pending = next_edge();
+  }
+
+  if (pending)
+    timer1_write(DISPLAY_TX_TICKS);
+  else
+    _running = false;
+  _ticks = _ticks + 1;
+  uint32_t cycles = _isr_cycles + ((esp_get_cycle_count() - started) >> cpu2x);
+  if (cycles >= DISPLAY_TX_CYCLES_PER_MS)
+  {
+    _isr_ms = _isr_ms + 1;
+    cycles -= DISPLAY_TX_CYCLES_PER_MS;
+  }
+  _isr_cycles = cycles;
+}
+
+// Sets the next edge of the queue, false once the queue is empty
+bool IRAM_ATTR DisplayTransmitter::next_edge()
+{
+  uint16_t tail = _tail;
+  if (_edge == 0)
+    _entry = _queue[tail];
+
+  bool done;
+  if (_entry & DISPLAY_TX_STOP)
+    done = stop_edge();
+  else if ((_entry & DISPLAY_TX_START) && _edge < DISPLAY_TX_START_EDGES)
+    done = start_edge();
+  else
+    done = bit_edge(_entry & DISPLAY_TX_START ? _edge - DISPLAY_TX_START_EDGES : _edge);
+
+  if (!done)
+  {
+    _edge++;
+    return true;
+  }
+  if (_entry & DISPLAY_TX_STOP)
+  {
+    _transfers_sent = _transfers_sent + 1;
+    if (!_mark_sent && _transfers_sent == _mark)
+    {
+      _marked_at = micros();
+      _mark_sent = true;
+    }
+  }
+  _edge = 0;
+  tail = (tail + 1) & (DISPLAY_TX_QUEUE_SIZE - 1);
+  _tail = tail;
+  return tail != _head;
+}
+
+uint32_t DisplayTransmitter::get_isr_us()
+{
+  noInterrupts();
+  uint32_t ms = _isr_ms;
+  uint32_t cycles = _isr_cycles;
+  interrupts();
+  return ms * 1000 + cycles / 80;
+}
+
+void DisplayTransmitter::log()
+{
+  uint32_t now = micros();
+  uint32_t isr_us = get_isr_us();
+  uint32_t elapsed = now - _logged_at;
+  uint32_t spent = isr_us - _logged_isr_us;
+  // Per mille of the wall time, the interrupt runs at either clock
+  uint32_t share = elapsed ? (uint32_t)((uint64_t)spent * 1000 / elapsed) : 0;
+  Serial.printf("Display: %lu transfers, %lu ticks, %lu us in the interrupt (%lu.%lu%% of the CPU since the last log), %lu stalls\n",
+                (unsigned long)_transfers_sent, (unsigned long)_ticks, (unsigned long)spent,
+                (unsigned long)(share / 10), (unsigned long)(share % 10), (unsigned long)_stalls);
+  _logged_at = now;
+  _logged_isr_us = isr_us;
+}
+
+// Lines are released (pulled up) by disabling the output and pulled low by enabling it.
+// Each of these sets one edge and returns true after the last one
+
+bool IRAM_ATTR DisplayTransmitter::start_edge()
+{
+  switch (_edge)
+  {
+  case 0:
+    GPES = _scl_mask;
+    break;
+  case 1:
+    GPEC = _sda_mask;
+    break;
+  case 2:
+    GPEC = _scl_mask;
+    break;
+  default:
+    // SDA falls while SCL is high
+    GPES = _sda_mask;
+    break;
+  }
+  return false;
+}
+
+bool IRAM_ATTR DisplayTransmitter::stop_edge()
+{
+  switch (_edge)
+  {
+  case 0:
+    GPES = _scl_mask;
+    break;
+  case 1:
+    GPES = _sda_mask;
+    break;
+  case 2:
+    GPEC = _scl_mask;
+    break;
+  default:
+    // SDA rises while SCL is high
+    GPEC = _sda_mask;
+    return true;
+  }
+  return false;
+}
+
+// Two edges per bit: SCL low with the next data bit, then SCL released for the display to sample it.
+// The ninth bit is the acknowledge, it is not checked like in u8x8_byte_sw_i2c
+bool IRAM_ATTR DisplayTransmitter::bit_edge(uint8_t edge)
+{
+  uint8_t bit = edge / 2;
+  if (edge & 1)
+  {
+    GPEC = _scl_mask;
+    return bit == 8;
+  }
+  GPES = _scl_mask;
+  if (bit < 8 && !(_entry & (0x80 >> bit)))
+    GPES = _sda_mask;
+  else
+    GPEC = _sda_mask;
+  return false;
+}
@@ -0,0 +1,105 @@
+#ifndef DISPLAY_TRANSMITTER_H
+#define DISPLAY_TRANSMITTER_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Queue entries, must be a power of two. Holds about two SH1106 frames
+#define DISPLAY_TX_QUEUE_SIZE 2048
+// Time between two interrupts, each one sets a burst of edges on the bus, two per bit
+#define DISPLAY_TX_TICK_PERIOD_US 100
+#define DISPLAY_TX_EDGES_PER_TICK 16
+// Time between two edges of a burst, the SCL low time of the SH1106 (1.3 us) is the longer one
+#define DISPLAY_TX_EDGE_GAP_NS 1300
+
+class VirtualSH1106;
+
+/*
+  Background transmission of the software I2C display bus.
+
+  begin() replaces the byte procedure of the display. Start, address, data and stop of every
+  transfer are put into a ring buffer and a timer1 interrupt sets one edge per tick on the pins,
+  it never waits for the bus itself. Drawing, u8g2_SendBuffer() and the picture loop only
+  enqueue, so network bytes and buttons are handled while a frame is on the bus. A full frame
+  takes about 125 ms, the page hash keeps most updates to a few pages. The queue holds about two
+  frames, the next frame can be drawn while the last one is still being sent. The producer only
+  waits if the queue is full.
+
+  The edges of a burst are spaced by busy waiting on the cycle counter, so the bus costs CPU
+  either way: about 23 us per 100 us tick while a frame is sent, roughly a quarter of the CPU
+  at 80 MHz for the time of the frame, and about 1200 interrupts per full frame instead of one
+  per edge. The time spent in the interrupt is accumulated and log() reports its share of the
+  CPU together with the stalls of the producer. A burst keeps interrupts from WiFi waiting for
+  up to about 25 us.
+
+  Only pins 0..15 can be used, they are driven open drain through the output enable register.
+*/
+class DisplayTransmitter
+{
+private:
+  static DisplayTransmitter *_instance;
+
+  uint16_t _queue[DISPLAY_TX_QUEUE_SIZE];
+  volatile uint16_t _head = 0;
+  volatile uint16_t _tail = 0;
+  volatile bool _running = false;
+  volatile uint32_t _transfers_sent = 0;
+  // Entry on the bus and its next edge, only used by the interrupt
+  uint16_t _entry;
+  uint8_t _edge = 0;
+  uint32_t _transfers_queued = 0;
+  uint32_t _stalls = 0;
+  // Time spent in the interrupt, whole milliseconds and the 80 MHz cycles of the one in progress
+  volatile uint32_t _ticks = 0;
+  volatile uint32_t _isr_ms = 0;
+  volatile uint32_t _isr_cycles = 0;
+  // Transfer count of the mark and the time the interrupt sent it
+  volatile uint32_t _mark = 0;
+  volatile bool _mark_sent = true;
+  volatile uint32_t _marked_at = 0;
+  uint32_t _logged_at = 0;
+  uint32_t _logged_isr_us = 0;
+
+  uint32_t _scl_mask;
+  uint32_t _sda_mask;
+  VirtualSH1106 *_monitor = nullptr;
+
+  static void on_timer();
+  static uint8_t byte_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+  void init_pins(uint8_t scl, uint8_t sda);
+  void push(uint16_t entry);
+  void transmit();
+  bool next_edge();
+  bool start_edge();
+  bool stop_edge();
+  bool bit_edge(uint8_t edge);
+
+public:
+  // Call before the display is initialized, the software I2C pins of the display are taken over
+  void begin(U8G2 &display);
+
+  // Completion flag: true once everything which was drawn is on the panel
+  bool is_idle() { return _head == _tail; }
+  void flush();
+  // Every queued transfer is also decoded by the monitor, e.g. to take screenshots
+  void set_monitor(VirtualSH1106 *monitor) { _monitor = monitor; }
+
+  // Marks everything queued so far, e.g. the reaction to a press. Once the last of it is on the
+  // panel is_mark_sent() becomes true and get_marked_at() is the micros() of that moment
+  void mark();
+  bool is_mark_sent() { return _mark_sent; }
+  uint32_t get_marked_at() { return _marked_at; }
+
+  uint32_t get_transfers_sent() { return _transfers_sent; }
+  uint32_t get_transfers_queued() { return _transfers_queued; }
+  // Number of times the producer had to wait for space in the queue
+  uint32_t get_stalls() { return _stalls; }
+  uint32_t get_ticks() { return _ticks; }
+  // Time spent in the interrupt since begin()
+  uint32_t get_isr_us();
+  // Logs the interrupt time and its share of the CPU since the last log
+  void log();
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef DISPLAY_VIEW_H
+#define DISPLAY_VIEW_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include <album_art.h>
+#include <display_list.h>
+#include <frame_store.h>
+
+// Font of all screens, the host tests draw with a small font from test/mocks instead
+#ifndef DISPLAY_VIEW_FONT
+#define DISPLAY_VIEW_FONT u8g_font_6x10
+#endif
+
+// Size of a text cut to the width of the display, the 6x10 font has at least 6 pixels per character
+#define DISPLAY_VIEW_TEXT_SIZE 96
+
+/*
+  Screens of the player. The views only depend on U8G2, so they can be drawn to any U8g2 device,
+  e.g. a full buffer or capture device, and be compared as PBM with u8g2_WriteBufferPBM() or
+  FrameStore::write_pbm().
+*/
+class DisplayView
+{
+private:
+  const char *_albumName;
+  const char *_trackName;
+  const char *_artistName;
+  const uint8_t *_albumArt;
+  // The text stays left of the cover while it is still loading, so it does not move when it arrives
+  bool _albumArtSpace;
+  bool _isPlaying;
+  // Album, track and artist cut to the space left of the cover
+  char _fittedText[3][DISPLAY_VIEW_TEXT_SIZE];
+  // Draw calls of the view, recorded once per frame and replayed per page
+  DisplayList _drawList;
+  void draw_play_button(int x, int y, int size)
+  {
+    int half_size = size / 2;
+    int x1 = x - half_size;
+    int y1 = y - half_size;
+    int y2 = y + half_size;
+
+    _drawList.draw_triangle(x1, y1, x1, y2, x + half_size, y);
+  }
+  void draw_pause_button(int x, int y, int width, int height)
+  {
+    int barSpacing = width;
+    int half_width = width / 2;
+    int half_height = height / 2;
+
+    _drawList.draw_box(x - barSpacing - half_width, y - half_height, width, height);
+    _drawList.draw_box(x + barSpacing - half_width, y - half_height, width, height);
+  }
+  // Returns text, or a copy in fitted which is cut to width pixels and ends with "..."
+  static const char *fit_text(U8G2 &display, const char *text, int width, char *fitted)
+  {
+    if (display.getUTF8Width(text) <= width)
+      return text;
+    int dots_width = display.getUTF8Width("...");
+    size_t cut = 0;
+    fitted[0] = '\0';
+    // Whole UTF-8 characters are taken as long as they and the dots fit
+    while (text[cut])
+    {
+      size_t next = cut + 1;
+      while ((text[next] & 0xC0) == 0x80)
+        next++;
+      if (next + sizeof("...") > DISPLAY_VIEW_TEXT_SIZE)
+        break;
+      memcpy(fitted + cut, text + cut, next - cut);
+      fitted[next] = '\0';
+      if (display.getUTF8Width(fitted) + dots_width > width)
+        break;
+      cut = next;
+    }
+    strcpy(fitted + cut, "...");
+    return fitted;
+  }
+  void record_text(U8G2 &display, int y, const char *text, int right, char *fitted)
+  {
+    if (text)
+      _drawList.draw_utf8(display, 10, y, fit_text(display, text, right - 10, fitted));
+  }
+  // The font has to be set before recording, it determines the bounding boxes of the text
+  void record_content(U8G2 &display)
+  {
+    _drawList.clear();
+    // Keep the track info left of the cover
+    int right = display.getDisplayWidth();
+    if (_albumArt || _albumArtSpace)
+    {
+      right -= ALBUM_ART_SIZE + 2;
+      _drawList.set_clip_window(0, 0, right, display.getDisplayHeight());
+    }
+    record_text(display, 30, _albumName, right, _fittedText[0]);
+    record_text(display, 10, _trackName, right, _fittedText[1]);
+    record_text(display, 20, _artistName, right, _fittedText[2]);
+    if (_albumArt || _albumArtSpace)
+      _drawList.set_max_clip_window();
+    if (_albumArt)
+    {
+      _drawList.draw_xbm(display.getDisplayWidth() - ALBUM_ART_SIZE, 0, ALBUM_ART_SIZE, ALBUM_ART_SIZE, _albumArt);
+    }
+    if (_isPlaying)
+      draw_play_button(display.getDisplayWidth() / 2, 50, 15);
+    else
+      draw_pause_button(display.getDisplayWidth() / 2, 50, 5, 15);
+  }
+
+public:
+  ~DisplayView()
+  {
+  }
+  void set_album(const char *title)
+  {
+    _albumName = title;
+  }
+  void set_track(const char *trackName)
+  {
+    _trackName = trackName;
+  }
+  void set_artist(const char *artistName)
+  {
+    _artistName = artistName;
+  }
+  void set_album_art(const uint8_t *albumArt)
+  {
+    _albumArt = albumArt;
+  }
+  void set_album_art_space(bool albumArtSpace)
+  {
+    _albumArtSpace = albumArtSpace;
+  }
+  void is_playing(bool isPlaying)
+  {
+    _isPlaying = isPlaying;
+  }
+  bool getPlayingState()
+  {
+    return _isPlaying;
+  }
+  const char *get_track()
+  {
+    return _trackName ? _trackName : "";
+  }
+  static void init(U8G2 &display)
+  {
+    // No clear of the panel, every page is overwritten and unchanged pages are not sent again
+    display.firstPage();
+    display.setFont(DISPLAY_VIEW_FONT);
+  }
+  // Every page is also captured into frame if one is given
+  void draw_music_view(U8G2 &display, FrameStore *frame = nullptr)
+  {
+    init(display);
+    record_content(display);
+    do
+    {
+      _drawList.replay(display);
+      if (frame)
+        frame->capture(display);
+    } while (display.nextPage());
+  }
+  // Renders the view into a frame without sending anything to the display
+  void render(U8G2 &display, FrameStore &frame)
+  {
+    display.setFont(DISPLAY_VIEW_FONT);
+    record_content(display);
+    for (uint8_t row = 0; row < FRAME_TILE_HEIGHT; row++)
+    {
+      display.setBufferCurrTileRow(row);
+      display.clearBuffer();
+      _drawList.replay(display);
+      frame.capture(display);
+    }
+  }
+  static void draw_message(U8G2 &display, const char *txt, int x, int y)
+  {
+    init(display);
+    do
+    {
+      display.drawStr(x, y, txt);
+    } while (display.nextPage());
+  }
+};
+
+class DisplayBuilder
+{
+private:
+  DisplayView _displayView;
+
+public:
+  ~DisplayBuilder()
+  {
+  }
+  DisplayBuilder()
+  {
+    _displayView = DisplayView();
+  }
+
+  DisplayBuilder &build_album(const char *title)
+  {
+    _displayView.set_album(title);
+    return *this;
+  }
+
+  DisplayBuilder &build_track(const char *trackName)
+  {
+    _displayView.set_track(trackName);
+    return *this;
+  }
+
+  DisplayBuilder &build_artist(const char *artist)
+  {
+    _displayView.set_artist(artist);
+    return *this;
+  }
+
+  DisplayBuilder &build_album_art(const uint8_t *albumArt)
+  {
+    _displayView.set_album_art(albumArt);
+    return *this;
+  }
+
+  DisplayBuilder &build_album_art_space(bool albumArtSpace)
+  {
+    _displayView.set_album_art_space(albumArtSpace);
+    return *this;
+  }
+
+  DisplayBuilder &build_play_stop_view(bool isPlaying)
+  {
+    _displayView.is_playing(isPlaying);
+    return *this;
+  }
+
+  DisplayView get_view()
+  {
+    return _displayView;
+  }
+};
+
+#endif
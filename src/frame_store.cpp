@@ -0,0 +1,111 @@
+#include <frame_store.h>
+#include <atomic_record.h>
+#include <checksum.h>
+
+#define FRAME_STORE_MAGIC 0x46524D31 // "FRM1"
+
+void FrameStore::capture(U8G2 &display)
+{
+  uint8_t row = display.getBufferCurrTileRow();
+  uint8_t rows = display.getBufferTileHeight();
+  if (row >= FRAME_TILE_HEIGHT || display.getBufferTileWidth() != FRAME_TILE_WIDTH)
+    return;
+  if (row + rows > FRAME_TILE_HEIGHT)
+    rows = FRAME_TILE_HEIGHT - row;
+  memcpy(&_frame[row * FRAME_TILE_WIDTH * 8], display.getBufferPtr(), rows * FRAME_TILE_WIDTH * 8);
+  _valid = true;
+}
+
+void FrameStore::set_frame(const uint8_t *frame)
+{
+  memcpy(_frame, frame, FRAME_BYTES);
+  _valid = true;
+}
+
+bool FrameStore::load()
+{
+  AtomicRecord record(FRAME_STORE_PATH, FRAME_STORE_MAGIC);
+  _valid = record.read(_frame, FRAME_BYTES) == FRAME_BYTES;
+  _checksum = _valid ? fnv1a(_frame, FRAME_BYTES) : 0;
+  return _valid;
+}
+
+bool FrameStore::save()
+{
+  if (!_valid)
+    return false;
+
+  // Only changed frames are written, a redraw of the same track costs no flash cycle
+  uint32_t checksum = fnv1a(_frame, FRAME_BYTES);
+  if (checksum == _checksum)
+    return true;
+
+  AtomicRecord record(FRAME_STORE_PATH, FRAME_STORE_MAGIC);
+  if (!record.write(_frame, FRAME_BYTES))
+    return false;
+  _checksum = checksum;
+  return true;
+}
+
+void FrameStore::begin_slide(U8G2 &display, const uint8_t *frame, uint8_t step)
+{
+  finish_slide(display);
+  _slide_frame = frame;
+  _slide_line = 0;
+  _slide_step = step;
+}
+
+bool FrameStore::slide_step(U8G2 &display)
+{
+  const uint8_t height = FRAME_TILE_HEIGHT * 8;
+  const uint16_t page_bytes = FRAME_TILE_WIDTH * 8;
+  if (!_slide_frame)
+    return false;
+
+  uint8_t line = _slide_line;
+  uint8_t next_line = line + _slide_step < height ? line + _slide_step : height;
+  uint8_t page[page_bytes];
+  // The lines are written while they still scroll out at the top, so the bottom never shows stale lines
+  for (uint8_t row = line / 8; row <= (next_line - 1) / 8; row++)
+  {
+    // RAM lines above next_line take the new frame, the rest still shows the old one
+    uint8_t lines = next_line - row * 8;
+    uint8_t mask = lines >= 8 ? 0xFF : (1 << lines) - 1;
+    const uint8_t *from = &_slide_frame[row * page_bytes];
+    const uint8_t *shown = &_frame[row * page_bytes];
+    for (uint16_t i = 0; i < page_bytes; i++)
+      page[i] = (from[i] & mask) | (shown[i] & ~mask);
+    display.drawTile(0, row, FRAME_TILE_WIDTH, page);
+  }
+  // With the start line at n, RAM lines above n wrap around to the bottom of the panel
+  display.setStartLine(next_line % height);
+  _slide_line = next_line;
+  if (next_line < height)
+    return true;
+
+  // The start line is back at 0 and the RAM holds the new frame
+  set_frame(_slide_frame);
+  _slide_frame = nullptr;
+  return false;
+}
+
+void FrameStore::finish_slide(U8G2 &display)
+{
+  while (slide_step(display))
+    ;
+}
+
+void FrameStore::write_pbm(void (*out)(const char *s))
+{
+  u8x8_capture_write_pbm_pre(FRAME_TILE_WIDTH, FRAME_TILE_HEIGHT, out);
+  u8x8_capture_write_pbm_buffer(_frame, FRAME_TILE_WIDTH, FRAME_TILE_HEIGHT, u8x8_capture_get_pixel_1, out);
+}
+
+bool FrameStore::restore(U8G2 &display)
+{
+  if (!_valid)
+    return false;
+  for (uint8_t row = 0; row < FRAME_TILE_HEIGHT; row++)
+    display.drawTile(0, row, FRAME_TILE_WIDTH, &_frame[row * FRAME_TILE_WIDTH * 8]);
+  return true;
+}
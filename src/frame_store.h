@@ -0,0 +1,57 @@
+#ifndef FRAME_STORE_H
+#define FRAME_STORE_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Geometry of the SH1106 128x64 panel in 8x8 tiles
+#define FRAME_TILE_WIDTH 16
+#define FRAME_TILE_HEIGHT 8
+#define FRAME_BYTES (FRAME_TILE_WIDTH * 8 * FRAME_TILE_HEIGHT)
+#define FRAME_STORE_PATH "/frame"
+
+/*
+  Copy of the last rendered frame in the tile layout of the display.
+
+  The page buffer only holds one tile row at a time, so capture() has to be called inside the
+  picture loop right before nextPage(). The frame can be written to flash and be put back on the
+  panel with plain tile transfers, without any drawing, e.g. right after a reboot.
+
+  begin_slide() moves another frame in from the bottom with the display start line, which sends
+  every page about once instead of a full frame per animation step. Every slide_step() writes the
+  next lines of the new frame and then moves the start line over them, so the caller decides the
+  pace. It expects the stored frame to be on the panel and keeps the new frame afterwards. The new
+  frame must not change until the slide is over, and nothing else may draw in between.
+*/
+class FrameStore
+{
+private:
+  uint8_t _frame[FRAME_BYTES];
+  // Checksum of the frame on flash, 0 if there is none
+  uint32_t _checksum = 0;
+  bool _valid = false;
+  // Frame which slides in, nullptr if there is none
+  const uint8_t *_slide_frame = nullptr;
+  uint8_t _slide_line;
+  uint8_t _slide_step;
+
+public:
+  void capture(U8G2 &display);
+  void set_frame(const uint8_t *frame);
+  bool is_valid() { return _valid; }
+  const uint8_t *get_frame() { return _frame; }
+
+  bool load();
+  bool save();
+  bool restore(U8G2 &display);
+  // A running slide is finished first
+  void begin_slide(U8G2 &display, const uint8_t *frame, uint8_t step);
+  // Moves the slide by one step, false once it is over
+  bool slide_step(U8G2 &display);
+  void finish_slide(U8G2 &display);
+  bool is_sliding() { return _slide_frame != nullptr; }
+  // Same output as u8g2_WriteBufferPBM() for a full buffer
+  void write_pbm(void (*out)(const char *s));
+};
+
+#endif
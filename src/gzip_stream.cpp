@@ -0,0 +1,394 @@
+#include <gzip_stream.h>
+#include <new>
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+
+// Base and extra bits of the length symbols 257..285 and of the distance symbols 0..29 (RFC 1951 3.2.5)
+static const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Repeat count of the code length symbols 16, 17 and 18
+static const uint8_t REPEAT_BASE[3] = {3, 3, 11};
+static const uint8_t REPEAT_EXTRA[3] = {2, 3, 7};
+
+// Order in which the code length code lengths are sent
+static const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+int GzipStream::read_byte()
+{
+  if (_in_pos == _in_len)
+  {
+    // Only takes what already arrived, so the end of the body never waits for the timeout
+    unsigned long start = millis();
+    int size;
+    while ((size = _source->available()) <= 0)
+    {
+      if (millis() - start >= _source->getTimeout())
+        return -1;
+      yield();
+    }
+    _in_len = _source->readBytes(_in_buf, (size_t)size < sizeof(_in_buf) ? size : sizeof(_in_buf));
+    _in_pos = 0;
+    _in_total += _in_len;
+    if (_in_len == 0)
+      return -1;
+  }
+  return _in_buf[_in_pos++];
+}
+
+int GzipStream::get_bits(uint8_t n)
+{
+  while (_bit_cnt < n)
+  {
+    int c = read_byte();
+    if (c < 0)
+      return -1;
+    _bit_buf |= (uint32_t)c << _bit_cnt;
+    _bit_cnt += 8;
+  }
+  int value = _bit_buf & ((1UL << n) - 1);
+  _bit_buf >>= n;
+  _bit_cnt -= n;
+  return value;
+}
+
+bool GzipStream::read_header()
+{
+  uint8_t header[10];
+  for (int i = 0; i < 10; i++)
+  {
+    int c = read_byte();
+    if (c < 0)
+      return false;
+    header[i] = c;
+  }
+  if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8)
+    return false;
+
+  uint8_t flags = header[3];
+  if (flags & GZIP_FLAG_EXTRA)
+  {
+    int lo = read_byte();
+    int hi = read_byte();
+    if (hi < 0)
+      return false;
+    for (int len = (hi << 8) | lo; len > 0; len--)
+    {
+      if (read_byte() < 0)
+        return false;
+    }
+  }
+  // Original file name and comment are zero terminated
+  for (uint8_t flag = GZIP_FLAG_NAME; flag <= GZIP_FLAG_COMMENT; flag <<= 1)
+  {
+    if (!(flags & flag))
+      continue;
+    int c;
+    while ((c = read_byte()) > 0)
+      ;
+    if (c < 0)
+      return false;
+  }
+  if (flags & GZIP_FLAG_HCRC)
+    return read_byte() >= 0 && read_byte() >= 0;
+  return true;
+}
+
+// Builds the canonical code from the code lengths, incomplete codes are allowed for single symbols
+bool GzipStream::build(Huffman &table, const uint8_t *lengths, uint16_t n)
+{
+  uint16_t offsets[16];
+  memset(table.count, 0, sizeof(table.count));
+  for (uint16_t symbol = 0; symbol < n; symbol++)
+    table.count[lengths[symbol]]++;
+  if (table.count[0] == n)
+    return true;
+
+  int left = 1;
+  for (int len = 1; len < 16; len++)
+  {
+    left = (left << 1) - table.count[len];
+    if (left < 0)
+      return false;
+  }
+
+  offsets[1] = 0;
+  for (int len = 1; len < 15; len++)
+    offsets[len + 1] = offsets[len] + table.count[len];
+  for (uint16_t symbol = 0; symbol < n; symbol++)
+  {
+    if (lengths[symbol])
+      table.symbol[offsets[lengths[symbol]]++] = symbol;
+  }
+  return true;
+}
+
+int GzipStream::decode(const Huffman &table)
+{
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (int len = 1; len < 16; len++)
+  {
+    int bit = get_bits(1);
+    if (bit < 0)
+      return -1;
+    code |= bit;
+    int count = table.count[len];
+    if (code - count < first)
+      return table.symbol[index + (code - first)];
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+bool GzipStream::read_fixed_tables()
+{
+  uint8_t lengths[288];
+  memset(lengths, 8, 144);
+  memset(lengths + 144, 9, 112);
+  memset(lengths + 256, 7, 24);
+  memset(lengths + 280, 8, 8);
+  if (!build(_lit, lengths, 288))
+    return false;
+  memset(lengths, 5, 30);
+  return build(_dist, lengths, 30);
+}
+
+bool GzipStream::read_dynamic_tables()
+{
+  int lit_cnt = get_bits(5);
+  int dist_cnt = get_bits(5);
+  int code_cnt = get_bits(4);
+  if (code_cnt < 0)
+    return false;
+  lit_cnt += 257;
+  dist_cnt += 1;
+  code_cnt += 4;
+  if (lit_cnt > 286 || dist_cnt > 30)
+    return false;
+
+  // The code length code is decoded with the distance table, it is rebuilt afterwards
+  uint8_t lengths[286 + 30] = {};
+  for (int i = 0; i < code_cnt; i++)
+  {
+    int len = get_bits(3);
+    if (len < 0)
+      return false;
+    lengths[CODE_LENGTH_ORDER[i]] = len;
+  }
+  uint16_t code_symbol[19];
+  Huffman code = {{}, code_symbol};
+  if (!build(code, lengths, 19))
+    return false;
+
+  int index = 0;
+  while (index < lit_cnt + dist_cnt)
+  {
+    int symbol = decode(code);
+    if (symbol < 0)
+      return false;
+    if (symbol < 16)
+    {
+      lengths[index++] = symbol;
+      continue;
+    }
+
+    // 16 repeats the previous length 3-6 times, 17 and 18 write 3-10 and 11-138 zeros
+    if (symbol == 16 && index == 0)
+      return false;
+    uint8_t len = symbol == 16 ? lengths[index - 1] : 0;
+    int repeat = get_bits(REPEAT_EXTRA[symbol - 16]);
+    if (repeat < 0)
+      return false;
+    repeat += REPEAT_BASE[symbol - 16];
+    if (index + repeat > lit_cnt + dist_cnt)
+      return false;
+    while (repeat--)
+      lengths[index++] = len;
+  }
+
+  // The end of block symbol must have a code
+  if (lengths[256] == 0)
+    return false;
+  return build(_lit, lengths, lit_cnt) && build(_dist, lengths + lit_cnt, dist_cnt);
+}
+
+bool GzipStream::read_block_header()
+{
+  int header = get_bits(3);
+  if (header < 0)
+    return false;
+  _last_block = header & 1;
+  switch (header >> 1)
+  {
+  case 0:
+  {
+    // Stored blocks start at a byte boundary
+    _bit_buf = 0;
+    _bit_cnt = 0;
+    int len = get_bits(16);
+    int nlen = get_bits(16);
+    if (nlen < 0 || (len ^ 0xFFFF) != nlen)
+      return false;
+    _stored_len = len;
+    _state = STORED;
+    return true;
+  }
+  case 1:
+    _state = HUFFMAN;
+    return read_fixed_tables();
+  case 2:
+    _state = HUFFMAN;
+    return read_dynamic_tables();
+  default:
+    return false;
+  }
+}
+
+void GzipStream::put(uint8_t c)
+{
+  _window[_written++ & (GZIP_WINDOW_SIZE - 1)] = c;
+}
+
+void GzipStream::end_block()
+{
+  _state = _last_block ? DONE : BLOCK_HEADER;
+}
+
+// Decodes one header, stored byte or symbol
+bool GzipStream::step()
+{
+  if (_state == BLOCK_HEADER)
+    return read_block_header();
+
+  if (_state == STORED)
+  {
+    if (_stored_len == 0)
+    {
+      end_block();
+      return true;
+    }
+    int c = read_byte();
+    if (c < 0)
+      return false;
+    put(c);
+    _stored_len--;
+    return true;
+  }
+
+  int symbol = decode(_lit);
+  if (symbol < 0)
+    return false;
+  if (symbol < 256)
+  {
+    put(symbol);
+    return true;
+  }
+  if (symbol == 256)
+  {
+    end_block();
+    return true;
+  }
+
+  symbol -= 257;
+  if (symbol >= 29)
+    return false;
+  int len = get_bits(LENGTH_EXTRA[symbol]);
+  if (len < 0)
+    return false;
+  len += LENGTH_BASE[symbol];
+  int dist_symbol = decode(_dist);
+  if (dist_symbol < 0 || dist_symbol >= 30)
+    return false;
+  int extra = get_bits(DIST_EXTRA[dist_symbol]);
+  if (extra < 0)
+    return false;
+  uint32_t dist = DIST_BASE[dist_symbol] + extra;
+  // Output is only decoded once all of it was read, so the whole window is history
+  if (dist > _written || dist > GZIP_WINDOW_SIZE)
+    return false;
+  while (len--)
+    put(_window[(_written - dist) & (GZIP_WINDOW_SIZE - 1)]);
+  return true;
+}
+
+// Decodes until output is available, false at the end of the stream or on an error
+bool GzipStream::fill()
+{
+  while (_written == _read)
+  {
+    if (_state == DONE || _state == FAILED)
+      return false;
+    if (!step())
+    {
+      _state = FAILED;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GzipStream::begin(Stream *source)
+{
+  end();
+  _source = source;
+  _written = 0;
+  _read = 0;
+  _last_block = false;
+  _in_pos = 0;
+  _in_len = 0;
+  _in_total = 0;
+  _bit_buf = 0;
+  _bit_cnt = 0;
+  _lit.symbol = _lit_symbol;
+  _dist.symbol = _dist_symbol;
+  setTimeout(source->getTimeout());
+
+  // The window is kept between the bodies, so every poll does not allocate and free 8 KB again
+  if (!_window)
+    _window = new (std::nothrow) uint8_t[GZIP_WINDOW_SIZE];
+  _state = _window && read_header() ? BLOCK_HEADER : FAILED;
+  return _state != FAILED;
+}
+
+void GzipStream::end()
+{
+  _state = DONE;
+}
+
+// Decodes the next output if nothing is pending, so 0 is only returned at the end of the body
+int GzipStream::available()
+{
+  fill();
+  return _written - _read;
+}
+
+int GzipStream::read()
+{
+  if (!fill())
+    return -1;
+  return _window[_read++ & (GZIP_WINDOW_SIZE - 1)];
+}
+
+int GzipStream::peek()
+{
+  if (!fill())
+    return -1;
+  return _window[_read & (GZIP_WINDOW_SIZE - 1)];
+}
@@ -0,0 +1,91 @@
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include <Arduino.h>
+
+// History kept for back references, a power of two. Deflate allows up to 32 KB, a response which
+// refers further back fails with has_error() and has to be requested again without gzip.
+#define GZIP_WINDOW_SIZE 8192
+
+/*
+  Stream which inflates a gzip encoded body while it is read.
+
+  The body is never held in memory: compressed bytes are pulled from the source in small chunks,
+  decoded symbol by symbol and the output is kept in a ring buffer of GZIP_WINDOW_SIZE bytes,
+  which is also the history for the back references. The window is allocated by the first begin()
+  and kept for the next bodies, so polling does not fragment the heap. Huffman codes are decoded canonically
+  bit by bit (like puff.c), which is fast enough for a few kilobytes of JSON per poll.
+  The trailer (CRC32 and size) is not checked, the parsers stop reading before it anyway.
+*/
+class GzipStream : public Stream
+{
+private:
+  enum State
+  {
+    BLOCK_HEADER,
+    STORED,
+    HUFFMAN,
+    DONE,
+    FAILED
+  };
+
+  struct Huffman
+  {
+    uint16_t count[16];
+    uint16_t *symbol;
+  };
+
+  Stream *_source = nullptr;
+  uint8_t *_window = nullptr;
+  uint32_t _written;
+  uint32_t _read;
+  State _state = DONE;
+  bool _last_block;
+  uint16_t _stored_len;
+
+  uint8_t _in_buf[64];
+  size_t _in_pos;
+  size_t _in_len;
+  uint32_t _in_total;
+  uint32_t _bit_buf;
+  uint8_t _bit_cnt;
+
+  uint16_t _lit_symbol[288];
+  uint16_t _dist_symbol[30];
+  Huffman _lit;
+  Huffman _dist;
+
+  int read_byte();
+  int get_bits(uint8_t n);
+  bool read_header();
+  bool build(Huffman &table, const uint8_t *lengths, uint16_t n);
+  int decode(const Huffman &table);
+  bool read_fixed_tables();
+  bool read_dynamic_tables();
+  bool read_block_header();
+  void put(uint8_t c);
+  void end_block();
+  bool step();
+  bool fill();
+
+public:
+  ~GzipStream() { delete[] _window; }
+
+  // Reads the gzip header from source, false if it is no deflate member or the window can't be allocated
+  bool begin(Stream *source);
+  // Keeps the window for the next body, the source is left untouched
+  void end();
+  bool has_error() { return _state == FAILED; }
+  // False once the deflate stream ended or failed, the body is over then even if the connection is not
+  bool is_inflating() { return _state != DONE && _state != FAILED; }
+  // Compressed bytes pulled from the source so far
+  uint32_t get_bytes_in() { return _in_total; }
+  uint32_t get_bytes_out() { return _read; }
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+};
+
+#endif
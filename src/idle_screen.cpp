@@ -0,0 +1,58 @@
+#include "idle_screen.h"
+#include <limits.h>
+
+void IdleScreen::begin(U8G2 &display)
+{
+  _display = &display;
+  _state = ACTIVE;
+  _idle = false;
+}
+
+void IdleScreen::set_idle(bool idle)
+{
+  if (idle == _idle)
+    return;
+  _idle = idle;
+  if (idle)
+    _idle_since = millis();
+  else
+    wake();
+}
+
+bool IdleScreen::wake()
+{
+  _idle_since = millis();
+  if (_state == ACTIVE)
+    return false;
+  if (_state == OFF)
+    _display->setPowerSave(0);
+  _display->setContrast(IDLE_SCREEN_CONTRAST);
+  _state = ACTIVE;
+  return true;
+}
+
+void IdleScreen::update()
+{
+  if (!_idle)
+    return;
+  unsigned long idle_time = millis() - _idle_since;
+  if (_state == ACTIVE && idle_time >= IDLE_SCREEN_DIM_TIMEOUT)
+  {
+    _display->setContrast(IDLE_SCREEN_DIM_CONTRAST);
+    _state = DIMMED;
+  }
+  if (_state == DIMMED && idle_time >= IDLE_SCREEN_OFF_TIMEOUT)
+  {
+    _display->setPowerSave(1);
+    _state = OFF;
+  }
+}
+
+unsigned long IdleScreen::get_next_change()
+{
+  if (!_idle || _state == OFF)
+    return ULONG_MAX;
+  unsigned long idle_time = millis() - _idle_since;
+  unsigned long timeout = _state == ACTIVE ? IDLE_SCREEN_DIM_TIMEOUT : IDLE_SCREEN_OFF_TIMEOUT;
+  return idle_time < timeout ? timeout - idle_time : 0;
+}
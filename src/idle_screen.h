@@ -0,0 +1,50 @@
+#ifndef IDLE_SCREEN_H
+#define IDLE_SCREEN_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Contrast of the init sequence of the SH1106 and the dimmed one
+#define IDLE_SCREEN_CONTRAST 0xCF
+#define IDLE_SCREEN_DIM_CONTRAST 0x01
+// Time without playback and without a button press until the panel dims and until it is switched off
+#define IDLE_SCREEN_DIM_TIMEOUT 30000
+#define IDLE_SCREEN_OFF_TIMEOUT 300000
+
+/*
+  Spares the OLED while nothing is playing.
+
+  Once playback stops, the panel is dimmed after IDLE_SCREEN_DIM_TIMEOUT and put into power save
+  after IDLE_SCREEN_OFF_TIMEOUT. The SH1106 keeps its RAM in power save, so wake() shows the last
+  frame again with two commands and without a redraw. A button press also restarts the timeouts.
+*/
+class IdleScreen
+{
+private:
+  enum State
+  {
+    ACTIVE,
+    DIMMED,
+    OFF
+  };
+
+  U8G2 *_display = nullptr;
+  State _state = ACTIVE;
+  bool _idle = false;
+  unsigned long _idle_since;
+
+public:
+  void begin(U8G2 &display);
+  // Called with every poll, leaving the idle state wakes the screen
+  void set_idle(bool idle);
+  // Brightens the screen and restarts the timeouts, false if it was already active
+  bool wake();
+  // Applies the timeouts
+  void update();
+  bool is_idle() { return _idle; }
+  bool is_active() { return _state == ACTIVE; }
+  // Milliseconds until update() changes the screen
+  unsigned long get_next_change();
+};
+
+#endif
@@ -5,7 +5,8 @@ String generate_random_string(int size);
 
 const String CLIENT_ID = "CLIENT ID";
 const String CLIENT_SECRET = "CLIENT SECRET";
-const String SCOPE = "user-read-private user-read-currently-playing user-modify-playback-state";
+// Bump TOKEN_STORE_MAGIC when the scope changes
+const String SCOPE = "user-read-private user-read-currently-playing user-read-playback-state user-modify-playback-state";
 const String REDIRECT_URL = "http://IP ADDRESS/callback";
 const String ERROR_PAGE = "<h1>Something went wrong</h1><p>Connection to Spotify Account went wrong. Please retry.</p>";
 const String SUCCESS_SITE = "<h1>Connection successful!</h1><p>You are now connected to your Spotify Account. You can now close this site.</p>";
@@ -20,6 +21,29 @@ const String HOMEPAGE =
     String(CLIENT_ID) + "&scope=" + String(SCOPE) + "&redirect_uri=" + String(REDIRECT_URL) + "&state=" + generate_random_string(16) + "'>here</a> to login to Spotify</p>\n"
                                                                                                                                        "</body>\n"
                                                                                                                                        "</html>\n";
+// Shown by /callback while the loop exchanges the code, polls /status until the login is done
+const String PROGRESS_PAGE =
+    "<!DOCTYPE html>\n"
+    "<html>\n"
+    "<head>\n"
+    "<title>Spotify Authentication</title>\n"
+    "</head>\n"
+    "<body>\n"
+    "<p>Connecting to your Spotify Account...</p>\n"
+    "<script>\n"
+    "function poll() {\n"
+    "  fetch('/status').then(r => r.text()).then(s => {\n"
+    "    if (s == 'done') document.body.innerHTML = '" +
+    SUCCESS_SITE + "';\n"
+                   "    else if (s == 'failed') document.body.innerHTML = '" +
+    ERROR_PAGE + "';\n"
+                 "    else setTimeout(poll, 1000);\n"
+                 "  }).catch(() => setTimeout(poll, 1000));\n"
+                 "}\n"
+                 "poll();\n"
+                 "</script>\n"
+                 "</body>\n"
+                 "</html>\n";
 String generate_random_string(int size)
 {
     String letters = "ABCDEFGHIKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890";
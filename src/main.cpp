@@ -9,173 +9,257 @@
 #include <U8g2lib.h>
 #include <Wire.h>
 #include <ArduinoJson.h>
+#include <album_art.h>
+#include <album_art_cache.h>
+#include <token_store.h>
+#include <token_manager.h>
+#include <frame_store.h>
+#include <wifi_cache.h>
+#include <button_input.h>
+#include <display_view.h>
+#include <display_transmitter.h>
+#include <virtual_sh1106.h>
+#include <parse_metrics.h>
+#include <gzip_stream.h>
+#include <response_parser.h>
+#include <request_policy.h>
+#include <cpu_governor.h>
+#include <power_scheduler.h>
+#include <idle_screen.h>
+#include <task_scheduler.h>
+#include <LittleFS.h>
 
 #define SKIP_TRACK_BUTTON 14
 #define PLAYBACK_BEHAVIOUR_BUTTON 12
 
-class DisplayView
-{
-private:
-  const char *_albumName;
-  const char *_trackName;
-  const char *_artistName;
-  bool _isPlaying;
-  void draw_play_button(U8G2_SH1106_128X64_NONAME_1_SW_I2C &display, int x, int y, int size)
-  {
-    int half_size = size / 2;
-    int x1 = x - half_size;
-    int y1 = y - half_size;
-    int y2 = y + half_size;
+// Index of the buttons in ButtonEvent::button
+#define PLAYBACK_BEHAVIOUR_EVENT 0
+#define SKIP_TRACK_EVENT 1
+const uint8_t BUTTON_PINS[BUTTON_COUNT] = {PLAYBACK_BEHAVIOUR_BUTTON, SKIP_TRACK_BUTTON};
+// Play / pause reacts on the press itself, skip waits for the release because a long press goes back
+const uint8_t BUTTON_GESTURES[BUTTON_COUNT] = {0, BUTTON_GESTURE_LONG};
 
-    display.drawTriangle(x1, y1, x1, y2, x + half_size, y);
-  }
-  void draw_pause_button(U8G2_SH1106_128X64_NONAME_1_SW_I2C &display, int x, int y, int width, int height)
-  {
-    int barSpacing = width;
-    int half_width = width / 2;
-    int half_height = height / 2;
+// Time for a reconnect with the cached channel and BSSID before falling back to a full scan
+#define WIFI_FAST_CONNECT_TIMEOUT 4000
+// Set to 1 to reuse the address of the last DHCP lease as static IP, saves the DHCP round trip
+#define WIFI_REUSE_LAST_IP 0
 
-    display.drawBox(x - barSpacing - half_width, y - half_height, width, height);
-    display.drawBox(x + barSpacing - half_width, y - half_height, width, height);
-  }
+// Set to 1 to clock the display bus from timer1 in the background, 0 sends frames from the loop
+// with u8g2. The transmitter logs the CPU share of its interrupt on every press, measure it next
+// to WiFi and TLS before turning it on
+#define DISPLAY_BACKGROUND_TX 0
+// Set to 1 to decode the display bus into a virtual SH1106 and serve it as /screen.pbm
+#define DISPLAY_MIRROR 0
+#if DISPLAY_MIRROR && !DISPLAY_BACKGROUND_TX
+#error "DISPLAY_MIRROR decodes the queue of the background transmitter, set DISPLAY_BACKGROUND_TX"
+#endif
 
-public:
-  ~DisplayView()
-  {
-  }
-  void set_album(const char *title)
-  {
-    _albumName = title;
-  }
-  void set_track(const char *trackName)
-  {
-    _trackName = trackName;
-  }
-  void set_artist(const char *artistName)
-  {
-    _artistName = artistName;
-  }
-  void is_playing(bool isPlaying)
-  {
-    _isPlaying = isPlaying;
-  }
-  bool getPlayingState()
-  {
-    return _isPlaying;
-  }
-  const char *get_track()
-  {
-    return _trackName ? _trackName : "";
-  }
-  static void init(U8G2_SH1106_128X64_NONAME_1_SW_I2C &display)
-  {
-    display.clear();
-    display.firstPage();
-    display.setFont(u8g_font_6x10);
-  }
-  void draw_music_view(U8G2_SH1106_128X64_NONAME_1_SW_I2C &display)
-  {
-    init(display);
-    do
-    {
-      if (_albumName)
-        display.drawUTF8(10, 30, _albumName);
-      if (_trackName)
-        display.drawUTF8(10, 10, _trackName);
-      if (_artistName)
-        display.drawUTF8(10, 20, _artistName);
-      if (_isPlaying)
-        draw_play_button(display, display.getDisplayWidth() / 2, 50, 15);
-      else
-        draw_pause_button(display, display.getDisplayWidth() / 2, 50, 5, 15);
-    } while (display.nextPage());
-  }
-  static void draw_message(U8G2_SH1106_128X64_NONAME_1_SW_I2C &display, const char *txt, int x, int y)
-  {
-    init(display);
-    do
-    {
-      display.drawStr(x, y, txt);
-    } while (display.nextPage());
-  }
-};
+// Last rendered music view, shown right after a reboot
+FrameStore last_frame;
+// Time the last show_music_view() blocked the loop, with DISPLAY_BACKGROUND_TX without the bus transfer
+unsigned long frame_time_us;
+// Press whose reaction is still on its way to the panel, logged once its last transfer is sent
+ButtonEvent drawing_press;
+bool press_drawing = false;
+// True while the panel shows last_frame, only then a new frame can slide in over it
+bool last_frame_shown = false;
+// Lines the start line moves per step of a track transition
+#define TRACK_SLIDE_STEP 4
+// Milliseconds between two steps of a track transition
+#define TRACK_SLIDE_INTERVAL 15
+unsigned long slid_at;
 
-class DisplayBuilder
-{
-private:
-  DisplayView _displayView;
+// Time and heap the response parsers need per endpoint, logged every PARSE_METRICS_LOG_INTERVAL responses
+ParseMetrics parse_metrics;
 
-public:
-  ~DisplayBuilder()
-  {
-  }
-  DisplayBuilder()
-  {
-    _displayView = DisplayView();
-  }
+// Raises the CPU clock to 160 MHz around TLS, parsing and rendering, the loop idles at 80 MHz
+CpuGovernor cpu;
+// Idles the CPU and the radio until the next poll, refresh or button is due
+PowerScheduler power;
+// Runs input, web, login, commands and the API requests by priority, input also at the yield points of the parsers
+TaskScheduler scheduler;
+// Time between two handleClient() calls
+#define WEB_SERVE_INTERVAL 50
+unsigned long web_served_at;
+unsigned long input_polled_at;
 
-  DisplayBuilder &build_album(const char *title)
-  {
-    _displayView.set_album(title);
-    return *this;
-  }
+// Time between two /me/player polls, the loop sleeps in between. Nothing changes quickly while idle
+#define PLAYER_POLL_INTERVAL 1000
+#define PLAYER_IDLE_POLL_INTERVAL 10000
+unsigned long player_polled_at;
+// Dims and switches off the panel while nothing is playing
+IdleScreen idle_screen;
 
-  DisplayBuilder &build_track(const char *trackName)
-  {
-    _displayView.set_track(trackName);
-    return *this;
-  }
+// API responses are requested gzip encoded and inflated while the parsers read them
+GzipStream gzip_body;
+const char *RESPONSE_HEADERS[] = {"Content-Encoding", "Retry-After"};
+// Cleared for an endpoint once its body refers back further than GZIP_WINDOW_SIZE
+bool gzip_user = true;
+bool gzip_player = true;
+bool gzip_queue = true;
 
-  DisplayBuilder &build_artist(const char *artist)
-  {
-    _displayView.set_artist(artist);
-    return *this;
-  }
+// Backoff and circuit breaker per endpoint, so a throttled or failing API is not hammered from the loop
+RequestPolicy token_policy("token");
+RequestPolicy player_policy("player");
+RequestPolicy queue_policy("queue");
+RequestPolicy command_policy("command");
 
-  DisplayBuilder &build_play_stop_view(bool isPlaying)
+const char *SSID = "SSID";
+const char *PASSWD = "WIFI PASSWORD";
+
+ESP8266WebServer server(80);
+// The CPU is boosted while connecting, which is mostly the TLS handshake. Waiting for the server runs at
+// the idle clock, the parsers boost it again while they decrypt and read the body
+class BoostedClient : public BearSSL::WiFiClientSecure
+{
+public:
+  using BearSSL::WiFiClientSecure::connect;
+
+  int connect(IPAddress ip, uint16_t port) override
   {
-    _displayView.is_playing(isPlaying);
-    return *this;
+    CpuBoost boost(cpu);
+    return BearSSL::WiFiClientSecure::connect(ip, port);
   }
 
-  DisplayView get_view()
+  int connect(const char *host, uint16_t port) override
   {
-    return _displayView;
+    CpuBoost boost(cpu);
+    return BearSSL::WiFiClientSecure::connect(host, port);
   }
 };
 
-const char *SSID = "SSID";
-const char *PASSWD = "WIFI PASSWORD";
-
-ESP8266WebServer server(80);
-std::unique_ptr<BearSSL::WiFiClientSecure> client = std::make_unique<BearSSL::WiFiClientSecure>();
+std::unique_ptr<BearSSL::WiFiClientSecure> client = std::make_unique<BoostedClient>();
 HTTPClient http;
-long unsigned int token_expire_time;
-int expires_counter;
 DisplayView current_view = DisplayView();
-DisplayView previous_view = DisplayView();
-String response;
+
+// Texts of the music view on the display, current_view only points into them
+char shown_track[TRACK_TEXT_SIZE] = "";
+char shown_album[TRACK_TEXT_SIZE] = "";
+char shown_artist[TRACK_TEXT_SIZE] = "";
+TokenStore token_store;
+
+// Playback state of the last /me/player poll
+PlayerState player;
+// Filled by the running poll, player keeps the last complete state
+PlayerState polled_player;
+// First track of the queue while it is parsed
+PlayerState queued_track;
+ResponseParser response_parser;
+
+// Dithered cover of the current album and the url it was downloaded from
+uint8_t album_art[ALBUM_ART_BYTES];
+bool has_album_art = false;
+char album_art_url[ART_URL_SIZE] = "";
+// An unknown cover is downloaded by the cover task once the text of the track is on the display
+bool album_art_pending = false;
+
+// First track of the queue, pre-rendered so a skip can show it without waiting for the server
+#define QUEUE_REFRESH_INTERVAL 30000
+FrameStore next_frame;
+bool next_frame_ready = false;
+bool next_frame_shown = false;
+bool queue_stale = true;
+unsigned long queue_fetched_at;
+char next_track[TRACK_TEXT_SIZE] = "";
+char next_album[TRACK_TEXT_SIZE] = "";
+char next_artist[TRACK_TEXT_SIZE] = "";
+char next_art_url[ART_URL_SIZE] = "";
+uint8_t next_album_art[ALBUM_ART_BYTES];
+bool next_has_album_art = false;
+AlbumArtCache album_art_cache;
+WifiCache wifi_cache;
+ButtonInput buttons;
 
 // true if the access token was requested
 bool got_access_token = false;
 
+// The code from /callback is exchanged by the loop, so the browser gets its answer at once
+enum LoginState
+{
+  LOGIN_IDLE,
+  LOGIN_PENDING,
+  LOGIN_DONE,
+  LOGIN_FAILED
+};
+const char *LOGIN_STATE_NAMES[] = {"idle", "pending", "done", "failed"};
+LoginState login_state = LOGIN_IDLE;
+String login_code;
+
 // true = playing; false = pause
 bool lastState = true;
 
-String access_token;
+// Time Spotify gets to report the result of a button press before the server state wins
+#define OPTIMISTIC_GRACE_PERIOD 4000
+
+// A pressed play / pause or skip is drawn at once and later confirmed or rolled back by a poll
+bool play_state_pending = false;
+unsigned long play_state_pending_since;
+bool skip_pending = false;
+unsigned long skip_pending_since;
+
+// Commands of drawn presses, sent by the command task so the press itself never waits for the network
+enum PlayerCommand
+{
+  COMMAND_PLAY,
+  COMMAND_PAUSE,
+  COMMAND_NEXT,
+  COMMAND_PREVIOUS
+};
+#define COMMAND_QUEUE_SIZE 4
+PlayerCommand command_queue[COMMAND_QUEUE_SIZE];
+uint8_t command_head = 0;
+uint8_t command_count = 0;
+
+// Access and refresh token of the session, the access token is renewed before it expires
+TokenManager tokens;
 
 void handle_not_found();
 void handle_root();
 void find_code_handler();
+void handle_login_status();
 bool request_access_token(String &code);
-bool request_refresh_token(const String &response);
-void get_currently_playing_track();
+bool request_refresh_token();
+void get_player_state(DisplayView &display_builder);
 String get_user_name();
+unsigned long get_poll_interval();
+void add_tasks();
 
 // Declaration of the OLED display
 U8G2_SH1106_128X64_NONAME_1_SW_I2C display(U8G2_R0, 5, 4, U8X8_PIN_NONE);
+// Clocks the display bus from a timer interrupt instead of the loop if DISPLAY_BACKGROUND_TX is set
+DisplayTransmitter display_tx;
+#if DISPLAY_MIRROR
+VirtualSH1106 display_mirror;
+String screen_pbm;
+void handle_screen();
+#endif
 DisplayView view_builder = DisplayView();
 
+void show_music_view(DisplayView &view)
+{
+  CpuBoost boost(cpu);
+  last_frame.finish_slide(display);
+  unsigned long start = micros();
+  view.draw_music_view(display, &last_frame);
+  frame_time_us = micros() - start;
+  last_frame_shown = true;
+}
+
+void show_message(const char *txt, int x, int y)
+{
+  last_frame.finish_slide(display);
+  DisplayView::draw_message(display, txt, x, y);
+  last_frame_shown = false;
+}
+
+// The address of the web interface, the login starts there
+void show_login_screen()
+{
+  login_state = LOGIN_IDLE;
+  String ip_addr = WiFi.localIP().toString();
+  show_message(ip_addr.c_str(), (128 - ip_addr.length()) / 4, 32);
+}
+
 void setup_server()
 {
   if (!MDNS.begin("esp8266"))
@@ -184,10 +268,34 @@ void setup_server()
   // Routing server
   server.on("/", handle_root);
   server.on("/callback", find_code_handler);
+  server.on("/status", handle_login_status);
+#if DISPLAY_MIRROR
+  server.on("/screen.pbm", handle_screen);
+#endif
   server.onNotFound(handle_not_found);
   server.begin();
 }
 
+#if DISPLAY_MIRROR
+void append_screen_pbm(const char *s)
+{
+  screen_pbm += s;
+}
+
+// Screenshot of what was sent to the panel, in the format of u8g2_WriteBufferPBM()
+void handle_screen()
+{
+  screen_pbm.reserve((SH1106_WIDTH + 1) * SH1106_HEIGHT + 16);
+  display_mirror.write_pbm(append_screen_pbm);
+  server.send(200, "image/x-portable-bitmap", screen_pbm);
+  screen_pbm = String();
+
+  Serial.printf("Display: %lu bus cycles in %lu transfers since the last screenshot\n",
+                (unsigned long)display_mirror.get_bus_cycles(), (unsigned long)display_mirror.get_transfers());
+  display_mirror.reset_counters();
+}
+#endif
+
 void handle_not_found()
 {
   String message = "Something went wrong:(\nPlease retry\n\n";
@@ -211,30 +319,128 @@ void handle_root()
   server.send(200, "text/html", HOMEPAGE);
 }
 
+// Starts the connection without waiting, the cached channel and BSSID skip the scan
+void connect_wifi()
+{
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+  if (wifi_cache.load())
+  {
+#if WIFI_REUSE_LAST_IP
+    WiFi.config(wifi_cache.get_ip(), wifi_cache.get_gateway(), wifi_cache.get_subnet(), wifi_cache.get_dns());
+#endif
+    WiFi.begin(SSID, PASSWD, wifi_cache.get_channel(), wifi_cache.get_bssid());
+  }
+  else
+    WiFi.begin(SSID, PASSWD);
+}
+
+void wait_for_wifi()
+{
+  unsigned long start = millis();
+  bool fast_connect = wifi_cache.is_valid();
+  while (WiFi.status() != WL_CONNECTED)
+  {
+    // The access point moved to another channel or the cached address is not valid anymore
+    if (fast_connect && millis() - start > WIFI_FAST_CONNECT_TIMEOUT)
+    {
+      fast_connect = false;
+      WiFi.disconnect();
+      WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+      WiFi.begin(SSID, PASSWD);
+    }
+    delay(100);
+  }
+  wifi_cache.save();
+}
+
 void setup()
 {
-  pinMode(SKIP_TRACK_BUTTON, INPUT);
-  pinMode(PLAYBACK_BEHAVIOUR_BUTTON, INPUT);
-  display.begin();
+  Serial.begin(115200);
+  cpu.begin();
+  power.begin(buttons);
+  buttons.begin(BUTTON_PINS, BUTTON_GESTURES);
+  add_tasks();
+  bool fs_mounted = LittleFS.begin();
+  if (fs_mounted)
+    album_art_cache.begin();
+
+  // The radio connects in the background while the display and the TLS client are set up
+  connect_wifi();
+#if DISPLAY_BACKGROUND_TX
+  display_tx.begin(display);
+#endif
+#if DISPLAY_MIRROR
+  display_tx.set_monitor(&display_mirror);
+#endif
+  display.beginSimple();
+  if (fs_mounted && last_frame.load())
+  {
+    last_frame_shown = last_frame.restore(display);
+    Serial.printf("Boot: first frame after %lu ms\n", millis());
+  }
+  else
+    display.clearDisplay();
+  display.setPowerSave(0);
+  idle_screen.begin(display);
   display.enableUTF8Print();
   client->setInsecure();
-  WiFi.begin(SSID, PASSWD);
-  while (WiFi.status() != WL_CONNECTED)
-    delay(500);
-  String ip_addr = WiFi.localIP().toString();
-  DisplayView::draw_message(display, ip_addr.c_str(), (128 - ip_addr.length()) / 4, 32);
+
+  wait_for_wifi();
+  Serial.printf("Boot: WiFi connected after %lu ms\n", millis());
   setup_server();
+
+  // Skip the web login if the refresh token of the last session is still valid
+  char stored_token[TOKEN_STORE_MAX_LENGTH + 1];
+  if (token_store.load(stored_token) && tokens.set_refresh_token(stored_token))
+    got_access_token = request_refresh_token();
+  if (!got_access_token)
+    show_login_screen();
 }
 
 void find_code_handler()
 {
   // Search for the code section in the uri to extract the authorisation code
-  String uri = server.arg("code");
-  got_access_token = request_access_token(uri);
+  String code = server.arg("code");
+  if (code.isEmpty() || login_state == LOGIN_PENDING)
+  {
+    handle_not_found();
+    return;
+  }
+
+  // The progress page polls /status until the loop exchanged the code
+  login_code = code;
+  login_state = LOGIN_PENDING;
+  server.send(200, "text/html", PROGRESS_PAGE);
+}
+
+void handle_login_status()
+{
+  server.send(200, "text/plain", LOGIN_STATE_NAMES[login_state]);
+}
+
+// Runs the token request of a login outside of the web server callback
+void exchange_login_code()
+{
+  if (login_state != LOGIN_PENDING)
+    return;
+  got_access_token = request_access_token(login_code);
+  login_state = got_access_token ? LOGIN_DONE : LOGIN_FAILED;
+  login_code = "";
+}
+
+// Call between http.begin() and the request, collecting the headers again clears the previous response
+void collect_response_headers(bool accept_gzip)
+{
+  http.collectHeaders(RESPONSE_HEADERS, 2);
+  if (accept_gzip)
+    http.addHeader("Accept-Encoding", "gzip");
+}
 
-  // If the request was successfull the server send the user back to the homepage
-  if (got_access_token)
-    server.send(200, "text/html", SUCCESS_SITE);
+// Seconds from the Retry-After header of the last response, 0 if it is missing
+long get_retry_after()
+{
+  return http.header("Retry-After").toInt();
 }
 
 bool is_valid_response(JsonDocument json)
@@ -245,6 +451,21 @@ bool is_valid_response(JsonDocument json)
          json.containsKey("scope");
 }
 
+// The body is parsed straight from the stream, the filter drops all other fields
+bool read_token_response(JsonDocument &json)
+{
+  JsonDocument filter;
+  filter["access_token"] = true;
+  filter["expires_in"] = true;
+  filter["refresh_token"] = true;
+  filter["scope"] = true;
+  CpuBoost boost(cpu);
+  parse_metrics.begin(PARSE_TOKEN, http.getSize());
+  DeserializationError error = deserializeJson(json, http.getStream(), DeserializationOption::Filter(filter));
+  parse_metrics.end();
+  return !error;
+}
+
 int str_width(String &str)
 {
   return display.getUTF8Width(str.c_str());
@@ -255,6 +476,7 @@ bool request_access_token(String &code)
   String auth = "Basic " + base64::encode(String(CLIENT_ID) + ":" + String(CLIENT_SECRET));
   String requestBody = "grant_type=authorization_code&code=" + code + "&redirect_uri=" + REDIRECT_URL;
   String url = "https://accounts.spotify.com/api/token";
+  http.useHTTP10(true);
   http.begin(*client, url);
   http.addHeader("Authorization", auth);
   http.addHeader("Content-Type", "application/x-www-form-urlencoded");
@@ -262,15 +484,15 @@ bool request_access_token(String &code)
   if (http_response_code == HTTP_CODE_OK)
   {
     JsonDocument json;
-    DeserializationError error = deserializeJson(json, http.getString());
-    if (error)
+    bool parsed = read_token_response(json);
+    http.end();
+    if (!parsed)
       return false;
 
-    if (is_valid_response(json))
+    if (is_valid_response(json) && tokens.set_access_token(json["access_token"], json["expires_in"]) &&
+        tokens.set_refresh_token(json["refresh_token"]))
     {
-      response = http.getString();
-      expires_counter = json["expires_in"];
-      access_token = json["access_token"].as<String>();
+      token_store.save(tokens.get_refresh_token());
 
       // Print greetings when successfully connecting to Spotify
       String greeting = "Hello " + get_user_name() + "!";
@@ -287,265 +509,748 @@ bool request_access_token(String &code)
       return true;
     }
   }
-  else
-  {
-    handle_not_found();
-  }
 
   http.end();
   return false;
 }
 
-bool request_refresh_token(const String &res)
+// Single flight, a refresh which is already running is not started again
+bool request_refresh_token()
 {
-  JsonDocument json_arr;
-  deserializeJson(json_arr, res);
-  if (json_arr.isNull() || !json_arr.containsKey("refresh_token") || json_arr.size() <= 1)
+  if (!tokens.has_refresh_token() || !tokens.begin_refresh())
     return false;
-  String refresh_token = json_arr["refresh_token"];
   String auth = "Basic " + base64::encode(String(CLIENT_ID) + ":" + String(CLIENT_SECRET));
-  String requestBody = "grant_type=refresh_token&refresh_token=" + refresh_token;
+  String requestBody = "grant_type=refresh_token&refresh_token=" + String(tokens.get_refresh_token());
   String url = "https://accounts.spotify.com/api/token";
+  http.useHTTP10(true);
   http.begin(*client, url);
   http.addHeader("Authorization", auth);
   http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+  collect_response_headers(false);
   int http_response_code = http.POST(requestBody);
+  long retry_after = get_retry_after();
+
+  bool refreshed = false;
   if (http_response_code == HTTP_CODE_OK)
   {
-    response = http.getString();
-    token_expire_time = json_arr["expires_in"];
-    access_token = json_arr["access_token"].as<String>();
-    expires_counter = millis();
-    return true;
+    JsonDocument json;
+    if (read_token_response(json) && tokens.set_access_token(json["access_token"], json["expires_in"]))
+    {
+      // Spotify only sends a new refresh token if it rotated the old one
+      const char *rotated = json["refresh_token"];
+      if (rotated)
+        tokens.set_refresh_token(rotated);
+      token_store.save(tokens.get_refresh_token());
+      refreshed = true;
+    }
+  }
+  else if (http_response_code == 400)
+  {
+    // The refresh token was revoked or is invalid, a new login is required
+    token_store.clear();
+    tokens.clear();
+    got_access_token = false;
+    show_login_screen();
   }
-
   http.end();
-  return false;
+  tokens.end_refresh();
+
+  // 401, 403 and a 200 which could not be read are no reason to back off for record(), but the next
+  // refresh would fail the same way
+  if (refreshed || (http_response_code != HTTP_CODE_OK && http_response_code != 401 && http_response_code != 403))
+    token_policy.record(http_response_code, retry_after);
+  else
+    token_policy.fail();
+  return refreshed;
 }
 
-String parse_json_value(HTTPClient &http, String key)
+// Body of the response, inflated while it is read if the server compressed it
+Stream &open_body()
 {
-  bool found = false;
-  bool searched = true;
-  String ret_str = "";
-
-  int len = http.getSize();
-  int index = 0;
   WiFiClient *stream = http.getStreamPtr();
-  char buffer[1]; // Buffer to store read characters
+  if (http.header("Content-Encoding") != "gzip")
+    return *stream;
+  gzip_body.begin(stream);
+  return gzip_body;
+}
 
-  // Loop until the connection is closed or data is available
-  while (http.connected() && (len > 0 || len == -1))
-  {
-    size_t size = stream->available();
-    if (size)
-    {
-      size_t read_bytes = stream->readBytes(buffer, ((size > sizeof(buffer)) ? sizeof(buffer) : size));
-      if (found)
-      {
-        if (buffer[0] != ':' && searched)
-          continue;
-        else if (buffer[0] != '\n')
-        {
-          if (buffer[0] == ':')
-          {
-            searched = false;
-            int i = stream->readBytes(buffer, 1);
-          }
-          else
-            ret_str += buffer[0];
-        }
-        else
-          break;
-      }
-      else if (buffer[0] == key[0])
-        index = 1;
-      else if (buffer[0] == key[index])
-      {
-        index++;
-        if (index == key.length())
-          found = true;
-      }
-      else if (buffer[0] != key[index])
-        index = 0;
-    }
-  }
+bool http_connected()
+{
+  return http.connected();
+}
 
-  if (*(ret_str.end() - 1) == ',')
+// The gzip trailer is never read, so the connection would stay open after an inflated body
+bool gzip_connected()
+{
+  return gzip_body.is_inflating();
+}
+
+void parser_yield_point()
+{
+  scheduler.yield_point();
+}
+
+// Starts the response parser on the body, inflated while it is read if the server compressed it
+ResponseParser &parse_body()
+{
+  Stream &body = open_body();
+  response_parser.begin(body, http.getSize(), &body == &gzip_body ? gzip_connected : http_connected,
+                        parser_yield_point);
+  return response_parser;
+}
+
+// False if the body could not be inflated, e.g. a back reference beyond GZIP_WINDOW_SIZE. The endpoint
+// is requested uncompressed from then on
+bool close_body(bool &gzip_enabled)
+{
+  bool inflated = !gzip_body.has_error();
+  if (!inflated)
   {
-    ret_str.substring(0, ret_str.length() - 1);
+    gzip_enabled = false;
+    Serial.printf("Gzip: inflating failed after %lu bytes, falling back to identity\n", (unsigned long)gzip_body.get_bytes_out());
   }
+  gzip_body.end();
+  return inflated;
+}
 
-  ret_str = ret_str.substring(1, ret_str.length() - 2);
+size_t read_album_art(void *ctx, uint8_t *buf, size_t len)
+{
+  scheduler.yield_point();
+  return static_cast<Stream *>(ctx)->readBytes(buf, len);
+}
 
-  // If track info is larger than the display width, a slice of the information is shown on the display
-  if (display.getStrWidth(ret_str.c_str()) > display.getDisplayWidth())
+// Downloads the cover and decodes it straight from the TLS stream into the thumbnail
+bool fetch_album_art(const char *url, uint8_t *xbm)
+{
+  bool decoded = false;
+  http.useHTTP10(true);
+  http.begin(*client, url);
+  if (http.GET() == HTTP_CODE_OK)
   {
-    int desired_width = 95;
-    int string_width = 0;
-    int index = 0;
-    String cutted_str = "";
-
-    // As long as the pixel width of the string is smaller than the max size the cutted_str get more chars
-    while (string_width <= desired_width)
-    {
-      cutted_str += ret_str[index];
-      string_width = display.getStrWidth(cutted_str.c_str());
-      index++;
-    }
-    cutted_str += "...";
-    ret_str = cutted_str;
+    CpuBoost boost(cpu);
+    std::unique_ptr<AlbumArtDecoder> decoder = std::make_unique<AlbumArtDecoder>();
+    decoded = decoder->decode(read_album_art, http.getStreamPtr(), xbm);
   }
-  return ret_str;
+  http.end();
+  return decoded;
+}
+
+// Repeated albums are served from flash, only unknown covers are downloaded and decoded
+bool load_album_art(const char *url, uint8_t *xbm)
+{
+  if (!url[0])
+    return false;
+  if (album_art_cache.get(url, xbm))
+    return true;
+  if (!fetch_album_art(url, xbm))
+    return false;
+  album_art_cache.put(url, xbm);
+  return true;
+}
+
+// The header is built in a fixed buffer, HTTPClient still copies it into its own header string
+void add_auth_header()
+{
+  static char auth[sizeof("Bearer ") + TOKEN_ACCESS_MAX_LENGTH];
+  snprintf(auth, sizeof(auth), "Bearer %s", tokens.get_access_token());
+  http.addHeader("Authorization", auth);
 }
 
 String get_user_name()
 {
-  String user_name = "";
+  char user_name[TRACK_TEXT_SIZE] = "";
+  if (!tokens.has_access_token())
+    return user_name;
 
-  if (!access_token.isEmpty())
+  // A body which could not be inflated is requested once more, close_body() turned gzip off for it
+  bool inflated;
+  do
   {
-    String auth = "Bearer " + access_token;
+    user_name[0] = '\0';
     http.useHTTP10(true);
     http.begin(*client, "https://api.spotify.com/v1/me");
-    http.addHeader("Authorization", auth);
-    int status_code = http.GET();
-    if (status_code != HTTP_CODE_OK)
-      return "";
-    user_name = parse_json_value(http, "display_name");
-  }
+    add_auth_header();
+    collect_response_headers(gzip_user);
+    inflated = true;
+    if (http.GET() == HTTP_CODE_OK)
+    {
+      CpuBoost boost(cpu);
+      parse_metrics.begin(PARSE_USER, http.getSize());
+      parse_body().parse_user(user_name, sizeof(user_name));
+      parse_metrics.end();
+      inflated = close_body(gzip_user);
+    }
+    http.end();
+  } while (!inflated);
   return user_name;
 }
 
-void get_currently_playing_track(DisplayView &display_builder)
+// Makes the prefetched track the shown one, its frame is already on the display
+void adopt_next_track()
+{
+  strcpy(shown_track, next_track);
+  strcpy(shown_album, next_album);
+  strcpy(shown_artist, next_artist);
+  memcpy(album_art, next_album_art, ALBUM_ART_BYTES);
+  has_album_art = next_has_album_art;
+  album_art_pending = false;
+  strcpy(album_art_url, next_art_url);
+  current_view = DisplayBuilder()
+                     .build_track(shown_track)
+                     .build_album(shown_album)
+                     .build_artist(shown_artist)
+                     .build_album_art(has_album_art ? album_art : nullptr)
+                     .build_play_stop_view(true)
+                     .get_view();
+  last_frame.finish_slide(display);
+  last_frame.set_frame(next_frame.get_frame());
+  last_frame.save();
+  next_frame_ready = false;
+}
+
+// Fetches the first track of the queue and renders its view into next_frame
+void prefetch_next_track()
+{
+  // The token is checked first, a request which is not sent must not take the probe of the policy
+  // The queue stays stale while the endpoint backs off
+  bool has_token = tokens.has_access_token();
+  if (has_token && !queue_policy.allow())
+    return;
+  queue_stale = false;
+  queue_fetched_at = millis();
+  next_frame_ready = false;
+  if (!has_token)
+    return;
+
+  http.useHTTP10(true);
+  http.begin(*client, "https://api.spotify.com/v1/me/player/queue");
+  add_auth_header();
+  collect_response_headers(gzip_queue);
+  int status_code = http.GET();
+  queue_policy.record(status_code, get_retry_after());
+  if (status_code != HTTP_CODE_OK)
+  {
+    http.end();
+    return;
+  }
+  PlayerState &queued = queued_track;
+  queued = PlayerState();
+  bool has_track;
+  {
+    // The cover below is downloaded at the idle clock
+    CpuBoost boost(cpu);
+    parse_metrics.begin(PARSE_QUEUE, http.getSize());
+    has_track = parse_body().parse_queue(queued);
+    parse_metrics.end();
+  }
+  bool inflated = close_body(gzip_queue);
+  http.end();
+  // An empty queue or a failed body leaves next_frame_ready false, the failed body is fetched again
+  // right away, uncompressed
+  queue_stale = !inflated;
+  if (!has_track || !inflated)
+    return;
+
+  strcpy(next_track, queued.track);
+  strcpy(next_album, queued.album);
+  strcpy(next_artist, queued.artist);
+  if (strcmp(queued.art_url, next_art_url) != 0)
+  {
+    next_has_album_art = load_album_art(queued.art_url, next_album_art);
+    strcpy(next_art_url, queued.art_url);
+  }
+
+  // Spotify starts playing after a skip, so the next track is rendered as playing
+  CpuBoost boost(cpu);
+  DisplayBuilder()
+      .build_track(next_track)
+      .build_album(next_album)
+      .build_artist(next_artist)
+      .build_album_art(next_has_album_art ? next_album_art : nullptr)
+      .build_play_stop_view(true)
+      .get_view()
+      .render(display, next_frame);
+  next_frame_ready = true;
+}
+
+// The server state wins, unless a press is younger than the time Spotify needs to report it
+void reconcile_play_state(DisplayView &display_builder, bool server_playing)
+{
+  if (play_state_pending)
+  {
+    bool confirmed = server_playing == display_builder.getPlayingState();
+    if (!confirmed && millis() - play_state_pending_since < OPTIMISTIC_GRACE_PERIOD)
+      return;
+    play_state_pending = false;
+  }
+  lastState = server_playing;
+  display_builder.is_playing(server_playing);
+  // Playback which resumed elsewhere wakes the screen
+  idle_screen.set_idle(!server_playing);
+}
+
+// One /me/player poll brings the item together with the play state, device and play modes
+void get_player_state(DisplayView &display_builder)
 {
-  if (!access_token.isEmpty())
+  if (tokens.has_access_token() && player_policy.allow())
   {
-    String auth = "Bearer " + String(access_token);
     http.useHTTP10(true);
-    http.begin(*client, "https://api.spotify.com/v1/me/player/currently-playing");
-    http.addHeader("Authorization", auth);
+    http.begin(*client, "https://api.spotify.com/v1/me/player");
+    add_auth_header();
+    collect_response_headers(gzip_player);
     int status_code = http.GET();
+    // 204 means there is no active device, the policy then polls slowly until music starts again
+    player_policy.record(status_code, get_retry_after());
+    if (status_code == HTTP_CODE_NO_CONTENT)
+      idle_screen.set_idle(true);
+    static bool first_poll = true;
+    if (first_poll)
+    {
+      first_poll = false;
+      Serial.printf("Boot: first poll after %lu ms\n", millis());
+    }
     if (status_code == HTTP_CODE_OK)
     {
-      // Get track data from the currently playing track
-      String artist_name = parse_json_value(http, "name");
-      String album_name = parse_json_value(http, "name");
-      String track_duration = parse_json_value(http, "duration_ms");
-      String track_name = parse_json_value(http, "name");
-      String track_progress = parse_json_value(http, "progress_ms");
-
-      current_view.set_track(track_name.c_str());
-      if (strcmp(current_view.get_track(), previous_view.get_track()) != 0 || display_builder.getPlayingState() != previous_view.getPlayingState())
+      CpuBoost boost(cpu);
+      PlayerState &state = polled_player;
+      state = PlayerState();
+      parse_metrics.begin(PARSE_PLAYER, http.getSize());
+      parse_body().parse_player(state);
+      parse_metrics.end();
+      bool inflated = close_body(gzip_player);
+      http.end();
+      // A truncated body is dropped and fetched again right away, uncompressed
+      if (!inflated)
+      {
+        player_polled_at = millis() - get_poll_interval();
+        return;
+      }
+
+      // Device and play modes are not on the display, they are only reported when they change
+      if (strcmp(state.device, player.device) != 0 || state.shuffle != player.shuffle ||
+          strcmp(state.repeat, player.repeat) != 0)
+        Serial.printf("Player: device %s, shuffle %s, repeat %s\n", state.device, state.shuffle ? "on" : "off",
+                      state.repeat);
+      player = state;
+
+      if (state.has_play_state)
+        reconcile_play_state(display_builder, state.playing);
+      // Without an item (ads, private sessions) the shown track stays
+      if (!state.has_item)
+        return;
+
+      bool track_changed = strcmp(state.track, shown_track) != 0;
+      bool redraw = track_changed || display_builder.getPlayingState() != current_view.getPlayingState();
+      if (skip_pending)
+      {
+        // The skip screen stays until the new track shows up or the grace period is over
+        bool expired = millis() - skip_pending_since >= OPTIMISTIC_GRACE_PERIOD;
+        skip_pending = !track_changed && !expired;
+        redraw = !skip_pending;
+
+        // The pre-rendered frame is already on the display if the server skipped to the predicted track
+        if (track_changed && next_frame_shown && strcmp(state.track, next_track) == 0 &&
+            display_builder.getPlayingState() && strcmp(state.art_url, next_art_url) == 0)
+        {
+          adopt_next_track();
+          redraw = false;
+        }
+        next_frame_shown = false;
+      }
+      if (track_changed)
+        queue_stale = true;
+
+      if (redraw)
       {
+        if (strcmp(state.art_url, album_art_url) != 0)
+        {
+          // Only a cached cover is drawn with the text, the download would hold the new track back
+          strcpy(album_art_url, state.art_url);
+          has_album_art = album_art_url[0] && album_art_cache.get(album_art_url, album_art);
+          album_art_pending = album_art_url[0] && !has_album_art;
+        }
+        strcpy(shown_track, state.track);
+        strcpy(shown_album, state.album);
+        strcpy(shown_artist, state.artist);
         current_view = DisplayBuilder()
-                           .build_track(current_view.get_track())
-                           .build_album(album_name.c_str())
-                           .build_artist(artist_name.c_str())
+                           .build_track(shown_track)
+                           .build_album(shown_album)
+                           .build_artist(shown_artist)
+                           .build_album_art(has_album_art ? album_art : nullptr)
+                           .build_album_art_space(album_art_pending)
                            .build_play_stop_view(display_builder.getPlayingState())
                            .get_view();
-        current_view.draw_music_view(display);
+        if (track_changed && last_frame_shown)
+        {
+          // The queue is fetched again after a track change, so its frame is free to take the new view
+          next_frame_ready = false;
+          current_view.render(display, next_frame);
+          last_frame.begin_slide(display, next_frame.get_frame(), TRACK_SLIDE_STEP);
+          slid_at = millis();
+        }
+        else
+        {
+          show_music_view(current_view);
+          last_frame.save();
+        }
       }
-      previous_view = current_view;
+      return;
     }
     http.end();
   }
 }
 
-void skip_track()
+// Sends a playback command, Spotify answers with 204 (sometimes 200) on success
+bool send_player_command(const char *method, const char *url)
 {
-  if (!access_token.isEmpty())
+  // A command which is not sent fails, so the optimistic screen is rolled back
+  if (!tokens.has_access_token() || !command_policy.allow())
+    return false;
+  http.useHTTP10(true);
+  http.begin(*client, url);
+  add_auth_header();
+  collect_response_headers(false);
+  int status_code = http.sendRequest(method, "");
+  command_policy.record(status_code, get_retry_after());
+  http.end();
+  return status_code >= 200 && status_code < 300;
+}
+
+bool skip_track()
+{
+  return send_player_command("POST", "https://api.spotify.com/v1/me/player/next");
+}
+
+bool previous_track()
+{
+  return send_player_command("POST", "https://api.spotify.com/v1/me/player/previous");
+}
+
+bool pause_playback()
+{
+  return send_player_command("PUT", "https://api.spotify.com/v1/me/player/pause");
+}
+
+bool resume_playback()
+{
+  return send_player_command("PUT", "https://api.spotify.com/v1/me/player/play");
+}
+
+// A press which is overtaken by the next one before its frame is sent is not logged
+void log_drawn_press()
+{
+  if (!press_drawing || !display_tx.is_mark_sent())
+    return;
+  press_drawing = false;
+  const ButtonEvent &event = drawing_press;
+  uint32_t latency = buttons.record_latency(event, display_tx.get_marked_at());
+  Serial.printf("Input: button %u event %u drawn after %lu us (avg %lu us, max %lu us)\n", event.button, event.type,
+                (unsigned long)latency, (unsigned long)buttons.get_average_latency(), (unsigned long)buttons.get_max_latency());
+#ifdef U8G2_WITH_PAGE_HASH
+  Serial.printf("Display: %lu pages sent, %lu unchanged pages skipped, last frame took %lu us\n",
+                (unsigned long)display.getPageSendCount(), (unsigned long)display.getPageSkipCount(), frame_time_us);
+#else
+  Serial.printf("Display: last frame took %lu us\n", frame_time_us);
+#endif
+#if DISPLAY_BACKGROUND_TX
+  display_tx.log();
+#endif
+}
+
+// The reaction to the press is queued, it is logged by log_drawn_press() once it is on the panel
+void log_press_to_pixel(const ButtonEvent &event)
+{
+  display_tx.mark();
+  drawing_press = event;
+  press_drawing = true;
+  log_drawn_press();
+}
+
+void show_play_state(bool playing)
+{
+  idle_screen.set_idle(!playing);
+  lastState = playing;
+  view_builder.is_playing(playing);
+  current_view.is_playing(playing);
+  show_music_view(current_view);
+}
+
+// Queues a command for the command task, false if the queue is full
+bool queue_command(PlayerCommand command)
+{
+  if (command_count == COMMAND_QUEUE_SIZE)
+    return false;
+  command_queue[(command_head + command_count++) % COMMAND_QUEUE_SIZE] = command;
+  return true;
+}
+
+// Play / pause toggles on every press, skip goes to the next track and a long skip press goes back.
+// The expected result is drawn at once, the command task sends the request and the polls confirm it.
+void handle_button_event(const ButtonEvent &event)
+{
+  // Presses beyond the queue are dropped before anything is drawn
+  if (event.type == BUTTON_LONG_PRESS && event.button == PLAYBACK_BEHAVIOUR_EVENT)
+    return;
+  if (command_count == COMMAND_QUEUE_SIZE)
+    return;
+
+  // The expected result is rendered at full speed
+  CpuBoost boost(cpu);
+  if (event.button == PLAYBACK_BEHAVIOUR_EVENT)
   {
-    String auth = "Bearer " + String(access_token);
-    http.useHTTP10(true);
-    http.begin(*client, "https://api.spotify.com/v1/me/player/next");
-    http.addHeader("Authorization", auth);
-    int status_code = http.POST("");
-    if (status_code != HTTP_CODE_OK)
-      return;
-    http.end();
+    bool playing = !lastState;
+    show_play_state(playing);
+    log_press_to_pixel(event);
+
+    play_state_pending = true;
+    play_state_pending_since = millis();
+    queue_command(playing ? COMMAND_PLAY : COMMAND_PAUSE);
+  }
+  else if (event.button == SKIP_TRACK_EVENT)
+  {
+    // A skip forward shows the pre-rendered next track, the next poll verifies it
+    next_frame_shown = event.type != BUTTON_LONG_PRESS && next_frame_ready;
+    if (next_frame_shown && last_frame_shown)
+    {
+      // The first step goes out with the press, the slide task moves the rest
+      last_frame.begin_slide(display, next_frame.get_frame(), TRACK_SLIDE_STEP);
+      last_frame.slide_step(display);
+      slid_at = millis();
+    }
+    else if (next_frame_shown)
+    {
+      next_frame.restore(display);
+      last_frame.set_frame(next_frame.get_frame());
+      last_frame_shown = true;
+    }
+    else
+      show_message("Skipping...", 31, 32);
+    log_press_to_pixel(event);
+
+    skip_pending = true;
+    skip_pending_since = millis();
+    queue_command(event.type == BUTTON_LONG_PRESS ? COMMAND_PREVIOUS : COMMAND_NEXT);
   }
 }
 
-void pause_playback()
+// Sends the oldest queued command and rolls its screen back if it failed
+void send_next_command()
 {
-  if (!access_token.isEmpty())
+  PlayerCommand command = command_queue[command_head];
+  command_head = (command_head + 1) % COMMAND_QUEUE_SIZE;
+  command_count--;
+
+  switch (command)
   {
-    String auth = "Bearer " + String(access_token);
-    http.useHTTP10(true);
-    http.begin(*client, "https://api.spotify.com/v1/me/player/pause");
-    http.addHeader("Authorization", auth);
-    int status_code = http.PUT("");
-    if (status_code != HTTP_CODE_OK)
-      return;
-    http.end();
+  case COMMAND_PLAY:
+  case COMMAND_PAUSE:
+  {
+    bool playing = command == COMMAND_PLAY;
+    if (!(playing ? resume_playback() : pause_playback()))
+    {
+      play_state_pending = false;
+      show_play_state(!playing);
+    }
+    break;
   }
+  case COMMAND_NEXT:
+  case COMMAND_PREVIOUS:
+    if (!(command == COMMAND_NEXT ? skip_track() : previous_track()))
+    {
+      skip_pending = false;
+      next_frame_shown = false;
+      show_music_view(current_view);
+    }
+    break;
+  }
+}
+
+// Milliseconds until elapsed reaches interval, 0 if it is already due
+unsigned long time_until(unsigned long elapsed, unsigned long interval)
+{
+  return elapsed < interval ? interval - elapsed : 0;
 }
 
-void resume_playback()
+unsigned long get_poll_interval()
 {
-  if (!access_token.isEmpty())
+  return idle_screen.is_idle() ? PLAYER_IDLE_POLL_INTERVAL : PLAYER_POLL_INTERVAL;
+}
+
+// Tasks of the scheduler, each one tells when it is due and does one step of its work
+
+unsigned long input_due()
+{
+  uint32_t edge;
+  if (buttons.get_pending_edge(edge))
+    return 0;
+  // A debounced or held button is polled again after BUTTON_DEBOUNCE_MS
+  return buttons.is_busy() ? time_until(millis() - input_polled_at, BUTTON_DEBOUNCE_MS) : ULONG_MAX;
+}
+
+void input_task()
+{
+  input_polled_at = millis();
+  log_drawn_press();
+  // Events are drained even without a login, so stale presses do not fire later
+  ButtonEvent event;
+  while (buttons.poll(event))
   {
-    String auth = "Bearer " + String(access_token);
-    http.useHTTP10(true);
-    http.begin(*client, "https://api.spotify.com/v1/me/player/play");
-    http.addHeader("Authorization", auth);
-    int status_code = http.PUT("");
-    if (status_code != HTTP_CODE_OK)
-      return;
-    http.end();
+    // The panel still holds the last frame, it only has to be switched on again
+    idle_screen.wake();
+    if (got_access_token)
+      handle_button_event(event);
   }
 }
 
-void loop()
+unsigned long web_due()
+{
+  return time_until(millis() - web_served_at, WEB_SERVE_INTERVAL);
+}
+
+void web_task()
 {
+  web_served_at = millis();
   server.handleClient();
-  if (got_access_token)
-  {
-    static unsigned long lastDebounceTime = 0;
-    const unsigned long debouncedDelay = 10; // 50
-    static bool lastButtonState = LOW;
-    bool playback_behaviour_changed = digitalRead(PLAYBACK_BEHAVIOUR_BUTTON);
+}
 
-    if (playback_behaviour_changed != lastButtonState)
-      lastDebounceTime = millis();
+unsigned long slide_due()
+{
+  if (!last_frame.is_sliding())
+    return ULONG_MAX;
+  // The next step waits until the last one is on the panel, the bus is slower than the interval
+  return display_tx.is_idle() ? time_until(millis() - slid_at, TRACK_SLIDE_INTERVAL) : 1;
+}
 
-    if ((millis() - lastDebounceTime) > debouncedDelay)
-    {
-      if (playback_behaviour_changed)
-      {
-        if (lastState)
-        {
-          resume_playback();
-          view_builder.is_playing(false);
-          lastState = false;
-        }
-        else
-        {
-          pause_playback();
-          view_builder.is_playing(true);
-          lastState = true;
-        }
-      }
-    }
+// A skip keeps the slid in frame off the flash until the next poll confirms the track
+void slide_task()
+{
+  slid_at = millis();
+  if (!last_frame.slide_step(display) && !skip_pending)
+    last_frame.save();
+}
 
-    lastButtonState = playback_behaviour_changed;
-    bool triggred_skip = digitalRead(SKIP_TRACK_BUTTON);
-    if (triggred_skip)
-    {
-      skip_track();
-      view_builder.is_playing(false);
-    }
+unsigned long command_due()
+{
+  return command_count ? 0 : ULONG_MAX;
+}
 
-    get_currently_playing_track(view_builder);
+unsigned long login_due()
+{
+  return login_state == LOGIN_PENDING ? 0 : ULONG_MAX;
+}
 
-    if ((millis() - expires_counter) / 1000 >= token_expire_time - 60)
-    {
-      if (!request_refresh_token(response))
-      {
-        const char *error_msg = "Couldn't refresh access token";
-        DisplayView::draw_message(display, error_msg, display.getDisplayWidth() / 2, display.getDisplayHeight() / 2);
-      }
-    }
+unsigned long screen_due()
+{
+  return idle_screen.get_next_change();
+}
+
+void screen_task()
+{
+  idle_screen.update();
+}
+
+unsigned long token_due()
+{
+  return got_access_token ? max(tokens.get_refresh_wait(), token_policy.get_remaining_wait()) : ULONG_MAX;
+}
+
+// The token is renewed ahead of its expiry, a failed refresh is retried with the backoff of the
+// token endpoint and only reported once the old token expired
+void token_task()
+{
+  if (!tokens.needs_refresh() || !token_policy.allow())
+    return;
+  // A revoked refresh token shows the login screen instead
+  if (!request_refresh_token() && got_access_token && !tokens.has_access_token())
+  {
+    const char *error_msg = "Couldn't refresh access token";
+    show_message(error_msg, display.getDisplayWidth() / 2, display.getDisplayHeight() / 2);
   }
-}
\ No newline at end of file
+}
+
+unsigned long player_due()
+{
+  if (!got_access_token)
+    return ULONG_MAX;
+  return max(time_until(millis() - player_polled_at, get_poll_interval()), player_policy.get_remaining_wait());
+}
+
+void player_task()
+{
+  player_polled_at = millis();
+  parse_metrics.begin_cycle();
+  get_player_state(view_builder);
+  parse_metrics.end_cycle(PARSE_PLAYER);
+}
+
+unsigned long cover_due()
+{
+  // The cover is drawn over the finished slide
+  return album_art_pending && !skip_pending && !last_frame.is_sliding() ? 0 : ULONG_MAX;
+}
+
+// Adds the cover to the track which is already on the display
+void cover_task()
+{
+  album_art_pending = false;
+  has_album_art = fetch_album_art(album_art_url, album_art);
+  if (has_album_art)
+    album_art_cache.put(album_art_url, album_art);
+  current_view.set_album_art(has_album_art ? album_art : nullptr);
+  current_view.set_album_art_space(false);
+  // A skip during the download owns the display now
+  if (last_frame_shown && !skip_pending)
+  {
+    show_music_view(current_view);
+    last_frame.save();
+  }
+}
+
+unsigned long queue_due()
+{
+  // The slide still reads next_frame
+  if (!got_access_token || skip_pending || last_frame.is_sliding())
+    return ULONG_MAX;
+  unsigned long queue_wait = queue_stale ? 0 : time_until(millis() - queue_fetched_at, QUEUE_REFRESH_INTERVAL);
+  return max(queue_wait, queue_policy.get_remaining_wait());
+}
+
+void queue_task()
+{
+  parse_metrics.begin_cycle();
+  prefetch_next_track();
+  parse_metrics.end_cycle(PARSE_QUEUE);
+}
+
+// A task which does not fit would silently never run, so the firmware stops right at boot instead
+void add_task(const char *name, task_due_cb due, task_run_cb run, uint32_t slice_us, bool nested)
+{
+  if (scheduler.add(name, due, run, slice_us, nested))
+    return;
+  Serial.printf("Scheduler: no room for task %s, raise TASK_SCHEDULER_MAX_TASKS\n", name);
+  Serial.flush();
+  panic();
+}
+
+// Highest priority first. Input and web are short and run at the yield points of the network tasks too,
+// the time slices are only used to count overruns
+void add_tasks()
+{
+  add_task("input", input_due, input_task, 20000, true);
+  add_task("web", web_due, web_task, 5000, true);
+  add_task("slide", slide_due, slide_task, 5000, false);
+  add_task("command", command_due, send_next_command, 1000000, false);
+  add_task("login", login_due, exchange_login_code, 2000000, false);
+  add_task("screen", screen_due, screen_task, 5000, false);
+  add_task("token", token_due, token_task, 2000000, false);
+  add_task("player", player_due, player_task, 1000000, false);
+  add_task("cover", cover_due, cover_task, 2000000, false);
+  add_task("queue", queue_due, queue_task, 2000000, false);
+}
+
+void loop()
+{
+  scheduler.run();
+  power.schedule(scheduler.get_next_due());
+  power.sleep(buttons, display_tx.is_idle());
+}
@@ -0,0 +1,87 @@
+#include "parse_metrics.h"
+#include <umm_malloc/umm_malloc.h>
+
+static const char *ENDPOINT_NAMES[PARSE_ENDPOINT_COUNT] = {"token", "me", "player", "queue"};
+
+uint32_t ParseMetrics::get_allocations()
+{
+#ifdef UMM_STATS_FULL
+  return umm_get_malloc_count() + umm_get_realloc_count();
+#else
+  return 0;
+#endif
+}
+
+void ParseMetrics::begin(ParseEndpoint endpoint, int size)
+{
+  _endpoint = endpoint;
+  _size = size;
+  _allocations = get_allocations();
+  // Resets the low water mark to the current free heap
+  _free_heap = umm_free_heap_size_min_reset();
+  _running = true;
+  _start = micros();
+}
+
+void ParseMetrics::end()
+{
+  uint32_t time_us = micros() - _start;
+  if (!_running)
+    return;
+  _running = false;
+
+  Stats &stats = _stats[_endpoint];
+  uint32_t size = _size > 0 ? _size : 0;
+  uint32_t heap = _free_heap - umm_free_heap_size_min();
+  uint32_t allocations = get_allocations() - _allocations;
+  stats.responses++;
+  stats.bytes += size;
+  stats.time_us += time_us;
+  if (size > stats.max_bytes)
+    stats.max_bytes = size;
+  if (time_us > stats.max_time_us)
+    stats.max_time_us = time_us;
+  if (heap > stats.max_heap)
+    stats.max_heap = heap;
+  if (allocations > stats.max_allocations)
+    stats.max_allocations = allocations;
+
+  if (stats.responses % PARSE_METRICS_LOG_INTERVAL == 1)
+    log(_endpoint);
+}
+
+void ParseMetrics::begin_cycle()
+{
+  _cycle_start_allocations = get_allocations();
+}
+
+void ParseMetrics::end_cycle(ParseEndpoint endpoint)
+{
+  Stats &stats = _stats[endpoint];
+  uint32_t allocations = get_allocations() - _cycle_start_allocations;
+  stats.cycles++;
+  stats.cycle_allocations += allocations;
+  if (allocations > stats.max_cycle_allocations)
+    stats.max_cycle_allocations = allocations;
+}
+
+void ParseMetrics::log(ParseEndpoint endpoint)
+{
+  const Stats &stats = _stats[endpoint];
+  if (!stats.responses)
+    return;
+  Serial.printf("Parse: %s %lu responses, %lu B/s, max %lu bytes in %lu us, max heap %lu bytes",
+                ENDPOINT_NAMES[endpoint], (unsigned long)stats.responses,
+                (unsigned long)(stats.time_us ? (uint64_t)stats.bytes * 1000000 / stats.time_us : 0),
+                (unsigned long)stats.max_bytes, (unsigned long)stats.max_time_us, (unsigned long)stats.max_heap);
+#ifdef UMM_STATS_FULL
+  Serial.printf(", max %lu allocations\n", (unsigned long)stats.max_allocations);
+  if (stats.cycles)
+    Serial.printf("Parse: %s %lu cycles, %lu allocations per cycle (max %lu)\n", ENDPOINT_NAMES[endpoint],
+                  (unsigned long)stats.cycles, (unsigned long)(stats.cycle_allocations / stats.cycles),
+                  (unsigned long)stats.max_cycle_allocations);
+#else
+  // The counters of umm_malloc only exist with UMM_STATS_FULL
+  Serial.printf(", allocations n/a\n");
+#endif
+}
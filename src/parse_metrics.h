@@ -0,0 +1,70 @@
+#ifndef PARSE_METRICS_H
+#define PARSE_METRICS_H
+
+#include <Arduino.h>
+
+// Responses per endpoint between two log lines, the first response is always logged
+#define PARSE_METRICS_LOG_INTERVAL 64
+
+enum ParseEndpoint
+{
+  PARSE_TOKEN,
+  PARSE_USER,
+  PARSE_PLAYER,
+  PARSE_QUEUE,
+  PARSE_ENDPOINT_COUNT
+};
+
+/*
+  Throughput and heap usage of the response parsers, measured on the device with the real payloads.
+
+  begin() is called once the status line is read and end() once the parser is done with the body,
+  the time in between is what the parser blocks the loop. The body size is the Content-Length,
+  which are the bytes received over the air (compressed for gzip bodies), so the bytes/s of a
+  parser change can be compared on the same payloads. Peak heap is the lowest free heap between
+  both calls (umm_malloc stats). Allocations are only counted with -D UMM_STATS_FULL, without it
+  the log shows them as n/a.
+
+  begin_cycle() and end_cycle() count the allocations of a whole poll: request, parser and
+  rendering. Inflating, parsing and rendering work on fixed buffers, test_allocations checks on the
+  host that they make no C++ allocations (operator new), malloc() and realloc() are not hooked
+  there. What is left comes from HTTPClient and the TLS client.
+*/
+class ParseMetrics
+{
+private:
+  struct Stats
+  {
+    uint32_t responses;
+    uint32_t bytes;
+    uint32_t time_us;
+    uint32_t max_bytes;
+    uint32_t max_time_us;
+    uint32_t max_heap;
+    uint32_t max_allocations;
+    uint32_t cycles;
+    uint32_t cycle_allocations;
+    uint32_t max_cycle_allocations;
+  };
+
+  Stats _stats[PARSE_ENDPOINT_COUNT] = {};
+  ParseEndpoint _endpoint;
+  int _size;
+  uint32_t _start;
+  uint32_t _free_heap;
+  uint32_t _allocations;
+  bool _running = false;
+  uint32_t _cycle_start_allocations;
+
+  static uint32_t get_allocations();
+
+public:
+  // size is the Content-Length of the body, -1 if it is unknown
+  void begin(ParseEndpoint endpoint, int size);
+  void end();
+  void begin_cycle();
+  void end_cycle(ParseEndpoint endpoint);
+  void log(ParseEndpoint endpoint);
+};
+
+#endif
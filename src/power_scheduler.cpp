@@ -0,0 +1,127 @@
+#include "power_scheduler.h"
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+#include <esp8266_peri.h>
+
+extern "C"
+{
+#include <user_interface.h>
+}
+
+uint8_t PowerScheduler::_pins[BUTTON_COUNT];
+volatile bool PowerScheduler::_waiting = false;
+volatile bool PowerScheduler::_light_sleeping = false;
+
+void IRAM_ATTR PowerScheduler::on_edge()
+{
+  // The wake-up level would fire the interrupt again and again while the button is held
+  if (_light_sleeping)
+  {
+    _light_sleeping = false;
+    restore_edges();
+  }
+  if (_waiting)
+    esp_schedule();
+}
+
+// Same interrupt type as attachInterrupt(CHANGE), this also clears the wake-up enable bit
+void IRAM_ATTR PowerScheduler::restore_edges()
+{
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    GPC(_pins[i]) = (GPC(_pins[i]) & ~(0xF << GPCI)) | (CHANGE << GPCI);
+}
+
+void PowerScheduler::begin(ButtonInput &buttons)
+{
+  buttons.set_edge_hook(on_edge);
+  _wait = POWER_MAX_SLEEP_MS;
+  _awake_since = micros();
+  _logged_at = millis();
+}
+
+void PowerScheduler::schedule(unsigned long wait_ms)
+{
+  if (wait_ms < _wait)
+    _wait = wait_ms;
+}
+
+void PowerScheduler::begin_light_sleep(ButtonInput &buttons)
+{
+  _light_sleeping = true;
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+  {
+    // A press between the read and the arming wakes the chip at once
+    _pins[i] = buttons.get_pin(i);
+    wifi_enable_gpio_wakeup(_pins[i], digitalRead(_pins[i]) ? GPIO_PIN_INTR_LOLEVEL : GPIO_PIN_INTR_HILEVEL);
+  }
+  WiFi.setSleepMode(WIFI_LIGHT_SLEEP);
+}
+
+void PowerScheduler::end_light_sleep()
+{
+  WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+  wifi_disable_gpio_wakeup();
+  noInterrupts();
+  if (_light_sleeping)
+  {
+    _light_sleeping = false;
+    restore_edges();
+  }
+  interrupts();
+}
+
+void PowerScheduler::sleep(ButtonInput &buttons, bool display_idle)
+{
+  unsigned long wait = _wait;
+  _wait = POWER_MAX_SLEEP_MS;
+
+  uint32_t start = micros();
+  _awake_us += start - _awake_since;
+  uint32_t edge;
+  bool light_sleep = display_idle && wait >= POWER_LIGHT_SLEEP_MIN_MS && !buttons.is_busy();
+  if (light_sleep)
+    begin_light_sleep(buttons);
+  _waiting = true;
+  if (!buttons.get_pending_edge(edge))
+    esp_delay(wait, [&buttons, &edge]() { return !buttons.get_pending_edge(edge); }, POWER_SLICE_MS);
+  _waiting = false;
+  if (light_sleep)
+    end_light_sleep();
+  _awake_since = micros();
+  _sleep_us += _awake_since - start;
+  if (light_sleep)
+    _light_sleep_us += _awake_since - start;
+
+  // Only edges which arrived during the sleep count, older ones were missed by the loop pass
+  if (buttons.get_pending_edge(edge) && edge - start < _awake_since - start)
+  {
+    uint32_t latency = _awake_since - edge;
+    _wake_cnt++;
+    _latency_total += latency;
+    if (latency > _latency_max)
+      _latency_max = latency;
+  }
+
+  if (millis() - _logged_at >= POWER_LOG_INTERVAL)
+    log();
+}
+
+uint32_t PowerScheduler::get_duty_cycle()
+{
+  uint64_t total = _awake_us + _sleep_us;
+  return total ? _awake_us * 100 / total : 100;
+}
+
+uint32_t PowerScheduler::get_light_sleep_share()
+{
+  uint64_t total = _awake_us + _sleep_us;
+  return total ? _light_sleep_us * 100 / total : 0;
+}
+
+void PowerScheduler::log()
+{
+  _logged_at = millis();
+  Serial.printf("Power: awake %lu%% of the time, %lu%% in light sleep, %lu wake-ups by buttons after %lu us (max %lu us)\n",
+                (unsigned long)get_duty_cycle(), (unsigned long)get_light_sleep_share(), (unsigned long)_wake_cnt,
+                (unsigned long)get_average_latency(), (unsigned long)_latency_max);
+}
@@ -0,0 +1,70 @@
+#ifndef POWER_SCHEDULER_H
+#define POWER_SCHEDULER_H
+
+#include <Arduino.h>
+#include <button_input.h>
+
+// Longest sleep, the web server is polled in between
+#define POWER_MAX_SLEEP_MS 100
+// Shorter waits stay in modem sleep, entering and leaving light sleep takes a few milliseconds
+#define POWER_LIGHT_SLEEP_MIN_MS 20
+// A button edge ends the sleep from its interrupt, the buttons are also checked after every slice
+#define POWER_SLICE_MS 5
+#define POWER_LOG_INTERVAL 60000
+
+/*
+  Sleeps between the deadlines of the loop.
+
+  Every loop pass reports when its jobs are due next with schedule(), sleep() then waits in
+  esp_delay() until the earliest deadline. A button edge ends the wait right away from its
+  interrupt handler.
+
+  A wait of at least POWER_LIGHT_SLEEP_MIN_MS while the buttons and the display bus are idle is
+  spent in automatic light sleep: the CPU is halted and the radio only wakes for the DTIM beacons.
+  Every button pin is armed to wake the chip on the level it does not have, the wake-up level
+  interrupt is turned back into the edge interrupt of ButtonInput by the edge hook. Light sleep
+  stops timer1, which clocks the display bus, so a running transfer keeps the station in modem
+  sleep, the default of the core.
+
+  The duty cycle (time awake / total time), the share of light sleep and the time from a button
+  edge to the wake-up are logged.
+*/
+class PowerScheduler
+{
+private:
+  static uint8_t _pins[BUTTON_COUNT];
+  static volatile bool _waiting;
+  static volatile bool _light_sleeping;
+
+  unsigned long _wait;
+  uint32_t _awake_since;
+  uint64_t _awake_us = 0;
+  uint64_t _sleep_us = 0;
+  uint64_t _light_sleep_us = 0;
+  uint32_t _wake_cnt = 0;
+  uint32_t _latency_total = 0;
+  uint32_t _latency_max = 0;
+  unsigned long _logged_at = 0;
+
+  static void on_edge();
+  static void restore_edges();
+  void begin_light_sleep(ButtonInput &buttons);
+  void end_light_sleep();
+
+public:
+  void begin(ButtonInput &buttons);
+  // A job is due in wait_ms, the earliest deadline of a loop pass wins
+  void schedule(unsigned long wait_ms);
+  // Light sleep is only entered if display_idle is true
+  void sleep(ButtonInput &buttons, bool display_idle);
+
+  // Percent of the time the CPU was awake
+  uint32_t get_duty_cycle();
+  // Percent of the time spent in light sleep
+  uint32_t get_light_sleep_share();
+  uint32_t get_average_latency() { return _wake_cnt ? _latency_total / _wake_cnt : 0; }
+  uint32_t get_max_latency() { return _latency_max; }
+  void log();
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "request_policy.h"
+
+static const char *STATE_NAMES[] = {"closed", "open", "half open"};
+
+void RequestPolicy::block(unsigned long duration)
+{
+  _blocked_since = millis();
+  _blocked_for = duration;
+}
+
+unsigned long RequestPolicy::get_backoff()
+{
+  unsigned long backoff = REQUEST_POLICY_MAX_BACKOFF;
+  if (_failures <= 16)
+    backoff = min((unsigned long)REQUEST_POLICY_BASE_BACKOFF << (_failures - 1), backoff);
+  return backoff / 2 + random(backoff / 2 + 1);
+}
+
+void RequestPolicy::fail(unsigned long retry_after_ms)
+{
+  _probing = false;
+  if (_failures < 255)
+    _failures++;
+  if (_state == HALF_OPEN || _failures >= REQUEST_POLICY_BREAKER_THRESHOLD)
+  {
+    // A server which asks for a longer pause than the cooldown gets it
+    _state = OPEN;
+    _trips++;
+    block(max(retry_after_ms, (unsigned long)REQUEST_POLICY_BREAKER_COOLDOWN));
+    log();
+    return;
+  }
+  block(retry_after_ms ? retry_after_ms : get_backoff());
+}
+
+unsigned long RequestPolicy::get_remaining_wait()
+{
+  unsigned long waited = millis() - _blocked_since;
+  return waited < _blocked_for ? _blocked_for - waited : 0;
+}
+
+bool RequestPolicy::allow()
+{
+  bool probe_lost = _probing && millis() - _probe_sent_at >= REQUEST_POLICY_BREAKER_COOLDOWN;
+  if ((_probing && !probe_lost) || get_remaining_wait())
+  {
+    _rejected++;
+    return false;
+  }
+  if (_state != CLOSED)
+  {
+    _state = HALF_OPEN;
+    _probing = true;
+    _probe_sent_at = millis();
+  }
+  _sent++;
+  return true;
+}
+
+void RequestPolicy::record(int status_code, long retry_after)
+{
+  _probing = false;
+  if (status_code >= 200 && status_code < 300)
+  {
+    bool was_open = _state != CLOSED;
+    _state = CLOSED;
+    _failures = 0;
+    _blocked_for = 0;
+    if (was_open)
+      log();
+    if (status_code == 204)
+    {
+      _idle++;
+      block(REQUEST_POLICY_IDLE_INTERVAL);
+    }
+  }
+  else if (status_code == 429)
+  {
+    _throttled++;
+    Serial.printf("Policy: %s throttled, retry after %ld s\n", _name, retry_after);
+    fail(retry_after > 0 ? retry_after * 1000UL : 0);
+  }
+  else if (status_code >= 500 || status_code < 0)
+  {
+    _errors++;
+    fail(0);
+  }
+  else if (_state == HALF_OPEN)
+  {
+    // The server answered, the circuit closes and the caller handles the client error
+    _state = CLOSED;
+    _failures = 0;
+    log();
+  }
+}
+
+void RequestPolicy::log()
+{
+  Serial.printf("Policy: %s %s for %lu ms, %lu sent, %lu skipped, %lu throttled, %lu errors, %lu idle, %lu trips\n",
+                _name, STATE_NAMES[_state], get_remaining_wait(), (unsigned long)_sent, (unsigned long)_rejected,
+                (unsigned long)_throttled, (unsigned long)_errors, (unsigned long)_idle, (unsigned long)_trips);
+}
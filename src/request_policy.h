@@ -0,0 +1,72 @@
+#ifndef REQUEST_POLICY_H
+#define REQUEST_POLICY_H
+
+#include <Arduino.h>
+
+// First delay after a failed call, doubled per consecutive failure up to the maximum
+#define REQUEST_POLICY_BASE_BACKOFF 1000
+#define REQUEST_POLICY_MAX_BACKOFF 60000
+// Consecutive failures which open the circuit, it stays open for the cooldown
+#define REQUEST_POLICY_BREAKER_THRESHOLD 5
+#define REQUEST_POLICY_BREAKER_COOLDOWN 120000
+// Pause after 204 No Content, nothing is playing so the endpoint is polled slowly
+#define REQUEST_POLICY_IDLE_INTERVAL 5000
+
+/*
+  Retry policy and circuit breaker of a single API endpoint.
+
+  allow() is asked before every call and record() gets the status code of every call:
+    2xx        success, closes the circuit (204 additionally pauses for REQUEST_POLICY_IDLE_INTERVAL)
+    429        throttled, waits for Retry-After or the backoff if the header is missing
+    5xx, < 0   server or connection error, waits for the backoff
+    other      client errors are no reason to back off, they are left to the caller
+  The backoff is exponential with equal jitter (half fixed, half random), so devices which failed
+  together do not retry together. After REQUEST_POLICY_BREAKER_THRESHOLD failures in a row the circuit
+  opens, once the cooldown is over a single probe is let through (half open) and its result either
+  closes the circuit or opens it again. Every other call waits while the probe is in flight, a probe
+  which is never recorded is replaced after REQUEST_POLICY_BREAKER_COOLDOWN.
+*/
+class RequestPolicy
+{
+private:
+  enum State
+  {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+  const char *_name;
+  State _state = CLOSED;
+  uint8_t _failures = 0;
+  unsigned long _blocked_since = 0;
+  unsigned long _blocked_for = 0;
+  bool _probing = false;
+  unsigned long _probe_sent_at = 0;
+
+  uint32_t _sent = 0;
+  uint32_t _rejected = 0;
+  uint32_t _throttled = 0;
+  uint32_t _errors = 0;
+  uint32_t _idle = 0;
+  uint32_t _trips = 0;
+
+  void block(unsigned long duration);
+  unsigned long get_backoff();
+
+public:
+  RequestPolicy(const char *name) : _name(name) {}
+
+  // False while the endpoint waits, the call has to be skipped
+  bool allow();
+  // retry_after is the Retry-After header in seconds, 0 if it is missing
+  void record(int status_code, long retry_after);
+  // A call which failed although record() would not back off, e.g. a 200 with an unreadable body.
+  // Waits retry_after_ms, or the backoff if it is 0
+  void fail(unsigned long retry_after_ms = 0);
+  bool is_open() { return _state != CLOSED; }
+  unsigned long get_remaining_wait();
+  void log();
+};
+
+#endif
@@ -0,0 +1,238 @@
+#include <response_parser.h>
+#include <album_art.h>
+
+static bool starts_with(const char *line, const char *prefix)
+{
+  return strncmp(line, prefix, strlen(prefix)) == 0;
+}
+
+// Value of a pretty printed "key" : "value" line without the quotes
+static void parse_line_string(const char *line, char *value, size_t size)
+{
+  value[0] = '\0';
+  const char *colon = strchr(line, ':');
+  const char *start = colon ? strchr(colon, '"') : nullptr;
+  if (!start)
+    return;
+  start++;
+  const char *end = strchr(start, '"');
+  size_t length = end ? end - start : strlen(start);
+  if (length >= size)
+    length = size - 1;
+  memcpy(value, start, length);
+  value[length] = '\0';
+}
+
+void ResponseParser::begin(Stream &body, int size, bool (*connected)(), void (*yield_point)())
+{
+  _body = &body;
+  _size = size;
+  _connected = connected;
+  _yield_point = yield_point;
+}
+
+void ResponseParser::yield_point()
+{
+  if (_yield_point)
+    _yield_point();
+}
+
+// Reads the rest of the line without surrounding whitespace, a line longer than the buffer is cut
+size_t ResponseParser::read_line(char *line, size_t size)
+{
+  size_t length = 0;
+  char c;
+  while (_body->readBytes(&c, 1) == 1 && c != '\n')
+  {
+    if (length + 1 < size)
+      line[length++] = c;
+  }
+  while (length > 0 && isspace((unsigned char)line[length - 1]))
+    length--;
+  line[length] = '\0';
+
+  size_t start = 0;
+  while (isspace((unsigned char)line[start]))
+    start++;
+  memmove(line, line + start, length - start + 1);
+  return length - start;
+}
+
+// Copies the value of the next "key" line into value without quotes and the trailing comma.
+// A value longer than the buffer is cut.
+void ResponseParser::json_value(const char *key, char *value, size_t size)
+{
+  bool found = false;
+  bool searched = true;
+  size_t key_length = strlen(key);
+  size_t length = 0;
+  size_t index = 0;
+  char buffer[1]; // Buffer to store read characters
+
+  while (is_open() && (_size > 0 || _size == -1))
+  {
+    yield_point();
+    if (_body->available())
+    {
+      _body->readBytes(buffer, 1);
+      if (found)
+      {
+        if (buffer[0] != ':' && searched)
+          continue;
+        else if (buffer[0] != '\n')
+        {
+          if (buffer[0] == ':')
+          {
+            searched = false;
+            _body->readBytes(buffer, 1);
+          }
+          else if (length + 1 < size)
+            value[length++] = buffer[0];
+        }
+        else
+          break;
+      }
+      else if (buffer[0] == key[0])
+        index = 1;
+      else if (buffer[0] == key[index])
+      {
+        index++;
+        if (index == key_length)
+          found = true;
+      }
+      else if (buffer[0] != key[index])
+        index = 0;
+    }
+  }
+
+  if (length > 0 && value[length - 1] == ',')
+    length--;
+  if (length > 0 && value[length - 1] == '"')
+    length--;
+  size_t start = length > 0 && value[0] == '"' ? 1 : 0;
+  memmove(value, value + start, length - start);
+  value[length - start] = '\0';
+}
+
+// Reads a boolean which is the last value of its line
+bool ResponseParser::json_bool(const char *key, bool &value)
+{
+  if (!_body->find(key))
+    return false;
+  char line[JSON_LINE_SIZE];
+  read_line(line, sizeof(line));
+  value = strstr(line, "true");
+  return true;
+}
+
+// Picks the smallest cover of the "images" array which is still at least ALBUM_ART_SIZE pixels high
+void ResponseParser::album_art_url(char *url, size_t size)
+{
+  url[0] = '\0';
+  int best_height = 0;
+  char line[JSON_LINE_SIZE];
+
+  if (!_body->find("\"images\""))
+    return;
+  read_line(line, sizeof(line));
+  if (strchr(line, ']'))
+    return;
+
+  // Every image attribute has its own line
+  char candidate[ART_URL_SIZE] = "";
+  int height = 0;
+  while (is_open())
+  {
+    yield_point();
+    read_line(line, sizeof(line));
+    if (starts_with(line, "\"height\""))
+    {
+      const char *colon = strchr(line, ':');
+      height = colon ? atoi(colon + 1) : 0;
+    }
+    else if (starts_with(line, "\"url\""))
+      parse_line_string(line, candidate, sizeof(candidate));
+
+    if (line[0] == '}' || line[0] == ']')
+    {
+      if (candidate[0] && height >= ALBUM_ART_SIZE && (best_height == 0 || height < best_height))
+      {
+        snprintf(url, size, "%s", candidate);
+        best_height = height;
+      }
+      candidate[0] = '\0';
+      height = 0;
+    }
+    if (strchr(line, ']'))
+      break;
+  }
+}
+
+// Reads the device and the play modes in front of the item, true if an item follows.
+// The keys are matched per line, so their order within the header does not matter.
+bool ResponseParser::player_header(PlayerState &state)
+{
+  bool in_device = false;
+  char line[JSON_LINE_SIZE];
+  while (is_open())
+  {
+    yield_point();
+    read_line(line, sizeof(line));
+    if (starts_with(line, "\"item\""))
+      return !strstr(line, "null");
+    if (starts_with(line, "\"device\""))
+      in_device = true;
+    else if (in_device && line[0] == '}')
+      in_device = false;
+    else if (in_device && starts_with(line, "\"name\""))
+      parse_line_string(line, state.device, sizeof(state.device));
+    else if (starts_with(line, "\"shuffle_state\""))
+      state.shuffle = strstr(line, "true");
+    else if (starts_with(line, "\"repeat_state\""))
+      parse_line_string(line, state.repeat, sizeof(state.repeat));
+    else if (starts_with(line, "\"is_playing\""))
+    {
+      state.playing = strstr(line, "true");
+      state.has_play_state = true;
+    }
+  }
+  return false;
+}
+
+void ResponseParser::item(PlayerState &state)
+{
+  char track_duration[16];
+  json_value("name", state.artist, sizeof(state.artist));
+  album_art_url(state.art_url, sizeof(state.art_url));
+  json_value("name", state.album, sizeof(state.album));
+  json_value("duration_ms", track_duration, sizeof(track_duration));
+  json_value("name", state.track, sizeof(state.track));
+}
+
+void ResponseParser::parse_user(char *name, size_t size)
+{
+  json_value("display_name", name, size);
+}
+
+bool ResponseParser::parse_player(PlayerState &state)
+{
+  // The item follows the device and the play modes, is_playing is usually sent after it
+  state.has_item = player_header(state);
+  if (state.has_item)
+    item(state);
+  if (!state.has_play_state)
+    state.has_play_state = json_bool("\"is_playing\"", state.playing);
+  return state.has_item;
+}
+
+bool ResponseParser::parse_queue(PlayerState &state)
+{
+  // Skip the currently playing track, an empty queue closes its array on the same line
+  char line[JSON_LINE_SIZE] = "]";
+  if (_body->find("\"queue\""))
+    read_line(line, sizeof(line));
+  state.has_item = !strchr(line, ']');
+  if (state.has_item)
+    item(state);
+  return state.has_item;
+}
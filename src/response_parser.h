@@ -0,0 +1,70 @@
+#ifndef RESPONSE_PARSER_H
+#define RESPONSE_PARSER_H
+
+#include <Arduino.h>
+
+// Buffers of the texts of a track, longer names are cut to the display width anyway
+#define TRACK_TEXT_SIZE 128
+#define ART_URL_SIZE 128
+#define DEVICE_NAME_SIZE 64
+#define REPEAT_STATE_SIZE 8
+// Longest pretty printed line the line parsers keep, the rest of a longer line is skipped
+#define JSON_LINE_SIZE 192
+
+// Playback state of a /me/player poll, or the first track of the queue
+struct PlayerState
+{
+  char track[TRACK_TEXT_SIZE] = "";
+  char album[TRACK_TEXT_SIZE] = "";
+  char artist[TRACK_TEXT_SIZE] = "";
+  char art_url[ART_URL_SIZE] = "";
+  char device[DEVICE_NAME_SIZE] = "";
+  char repeat[REPEAT_STATE_SIZE] = "";
+  bool shuffle = false;
+  bool playing = false;
+  bool has_play_state = false;
+  bool has_item = false;
+};
+
+/*
+  Streaming parsers of the Web API responses.
+
+  The body is read straight from the stream, byte by byte or line by line, and never held in
+  memory. Spotify pretty prints its JSON with one value per line, the parsers rely on that and
+  on the order of the fields within an item (artist, album images, album, duration, track). The
+  values are copied into fixed buffers, nothing is allocated.
+
+  A body is over once connected() is false and the stream has nothing buffered, an inflated body
+  outlasts its connection. yield_point() runs at every step, the firmware handles buttons and the
+  web server there while it waits for the next bytes.
+*/
+class ResponseParser
+{
+private:
+  Stream *_body = nullptr;
+  int _size;
+  bool (*_connected)() = nullptr;
+  void (*_yield_point)() = nullptr;
+
+  bool is_open() { return (_connected && _connected()) || _body->available(); }
+  void yield_point();
+  size_t read_line(char *line, size_t size);
+  void json_value(const char *key, char *value, size_t size);
+  bool json_bool(const char *key, bool &value);
+  void album_art_url(char *url, size_t size);
+  bool player_header(PlayerState &state);
+  void item(PlayerState &state);
+
+public:
+  // size is the Content-Length of the body, -1 if it is unknown. Both hooks are optional
+  void begin(Stream &body, int size, bool (*connected)() = nullptr, void (*yield_point)() = nullptr);
+
+  // display_name of /v1/me
+  void parse_user(char *name, size_t size);
+  // Device, play modes, play state and item of /v1/me/player, false if there is no item
+  bool parse_player(PlayerState &state);
+  // First track of /v1/me/player/queue, false if the queue is empty
+  bool parse_queue(PlayerState &state);
+};
+
+#endif
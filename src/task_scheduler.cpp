@@ -0,0 +1,118 @@
+#include "task_scheduler.h"
+#include <limits.h>
+
+bool TaskScheduler::add(const char *name, task_due_cb due, task_run_cb run, uint32_t slice_us, bool nested)
+{
+  if (_count == TASK_SCHEDULER_MAX_TASKS)
+    return false;
+  _tasks[_count++] = {name, due, run, slice_us, nested, false, 0, 0, 0, 0, 0, 0};
+  return true;
+}
+
+// First due task in priority order which is not in skip, the running task is never started again
+int8_t TaskScheduler::find_due(bool nested_only, uint32_t skip)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Task &task = _tasks[i];
+    if (i == _running || (skip & (1UL << i)) || (nested_only && !task.nested))
+      continue;
+    if (task.due() != 0)
+    {
+      task.waiting = false;
+      continue;
+    }
+    if (!task.waiting)
+    {
+      task.waiting = true;
+      task.due_since = micros();
+    }
+    return i;
+  }
+  return -1;
+}
+
+void TaskScheduler::execute(uint8_t index)
+{
+  Task &task = _tasks[index];
+  int8_t outer = _running;
+  uint32_t nested_before = _nested_us;
+  uint32_t start = micros();
+  uint32_t late = start - task.due_since;
+  task.waiting = false;
+
+  _running = index;
+  _depth++;
+  task.run();
+  _depth--;
+  _running = outer;
+
+  uint32_t total = micros() - start;
+  // Time of the tasks which ran at the yield points of this one is accounted to them
+  uint32_t elapsed = total - (_nested_us - nested_before);
+  // The whole run of a nested task is taken off the task it interrupted
+  if (_depth > 0)
+    _nested_us += total;
+
+  task.runs++;
+  task.cpu_us += elapsed;
+  if (elapsed > task.max_us)
+    task.max_us = elapsed;
+  if (elapsed > task.slice_us)
+    task.overruns++;
+  if (late > task.max_late_us)
+    task.max_late_us = late;
+}
+
+void TaskScheduler::run()
+{
+  // Every task runs at most once per pass, so a task which stays due can't starve the others
+  uint32_t ran = 0;
+  int8_t index;
+  while ((index = find_due(false, ran)) >= 0)
+  {
+    ran |= 1UL << index;
+    execute(index);
+  }
+
+  if (millis() - _logged_at >= TASK_LOG_INTERVAL)
+    log();
+}
+
+void TaskScheduler::yield_point()
+{
+  if (_depth != 1 || micros() - _checked_at < TASK_YIELD_CHECK_US)
+    return;
+  _checked_at = micros();
+  int8_t index;
+  uint32_t ran = 0;
+  while ((index = find_due(true, ran)) >= 0)
+  {
+    ran |= 1UL << index;
+    execute(index);
+  }
+}
+
+unsigned long TaskScheduler::get_next_due()
+{
+  unsigned long next = ULONG_MAX;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    unsigned long due = _tasks[i].due();
+    if (due < next)
+      next = due;
+  }
+  return next;
+}
+
+void TaskScheduler::log()
+{
+  _logged_at = millis();
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    const Task &task = _tasks[i];
+    Serial.printf("Task: %s %lu runs, %lu ms cpu, max %lu us, %lu over %lu us, max %lu us late\n", task.name,
+                  (unsigned long)task.runs, (unsigned long)(task.cpu_us / 1000), (unsigned long)task.max_us,
+                  (unsigned long)task.overruns, (unsigned long)task.slice_us, (unsigned long)task.max_late_us);
+  }
+}
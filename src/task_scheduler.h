@@ -0,0 +1,73 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define TASK_SCHEDULER_MAX_TASKS 10
+// Time between two checks of yield_point(), keeps the byte wise parsers fast
+#define TASK_YIELD_CHECK_US 1000
+#define TASK_LOG_INTERVAL 60000
+
+// Returns the milliseconds until the task is due, 0 if it is due now and ULONG_MAX if it has nothing to do
+typedef unsigned long (*task_due_cb)();
+typedef void (*task_run_cb)();
+
+/*
+  Cooperative scheduler of the loop.
+
+  Every task reports when it is due next, run() executes the due tasks one after the other, the
+  one with the highest priority (lowest number) first. get_next_due() tells the power scheduler how
+  long the loop may sleep.
+
+  Long network jobs call yield_point() while they wait for or parse a response. It runs the due
+  tasks which are marked as nested, like input and the web server, so a button press is drawn
+  while a poll is still receiving. Nested tasks must not use the HTTP client and must not
+  yield themselves, only one level of nesting is allowed.
+
+  Per task the runs, the CPU time (without the nested tasks it was interrupted by), the longest
+  run, the runs over the time slice and the longest delay between due and start are tracked.
+*/
+class TaskScheduler
+{
+private:
+  struct Task
+  {
+    const char *name;
+    task_due_cb due;
+    task_run_cb run;
+    uint32_t slice_us;
+    bool nested;
+    bool waiting;
+    uint32_t due_since;
+    uint32_t runs;
+    uint32_t overruns;
+    uint64_t cpu_us;
+    uint32_t max_us;
+    uint32_t max_late_us;
+  };
+
+  Task _tasks[TASK_SCHEDULER_MAX_TASKS];
+  uint8_t _count = 0;
+  int8_t _running = -1;
+  uint8_t _depth = 0;
+  uint32_t _nested_us = 0;
+  uint32_t _checked_at = 0;
+  unsigned long _logged_at = 0;
+
+  int8_t find_due(bool nested_only, uint32_t skip);
+  void execute(uint8_t index);
+
+public:
+  // Tasks are added in priority order, the first one has the highest priority
+  bool add(const char *name, task_due_cb due, task_run_cb run, uint32_t slice_us, bool nested);
+  void run();
+  void yield_point();
+  unsigned long get_next_due();
+  // Counters of the task at index, in the order the tasks were added
+  uint32_t get_runs(uint8_t index) { return _tasks[index].runs; }
+  uint64_t get_cpu_us(uint8_t index) { return _tasks[index].cpu_us; }
+  uint32_t get_max_us(uint8_t index) { return _tasks[index].max_us; }
+  void log();
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "token_manager.h"
+#include <limits.h>
+
+bool TokenManager::copy(char *dest, size_t size, const char *src)
+{
+  if (!src)
+    return false;
+  size_t length = strlen(src);
+  if (length == 0 || length >= size)
+    return false;
+  memcpy(dest, src, length + 1);
+  return true;
+}
+
+uint32_t TokenManager::get_refresh_point()
+{
+  return _lifetime > 2 * TOKEN_REFRESH_AHEAD ? _lifetime - TOKEN_REFRESH_AHEAD : _lifetime / 2;
+}
+
+bool TokenManager::set_access_token(const char *token, uint32_t expires_in)
+{
+  if (expires_in == 0 || !copy(_access, sizeof(_access), token))
+    return false;
+  _granted_at = millis();
+  _lifetime = expires_in * 1000UL;
+  return true;
+}
+
+bool TokenManager::set_refresh_token(const char *token)
+{
+  return copy(_refresh, sizeof(_refresh), token);
+}
+
+void TokenManager::clear()
+{
+  _access[0] = '\0';
+  _refresh[0] = '\0';
+  _lifetime = 0;
+}
+
+bool TokenManager::needs_refresh()
+{
+  if (!has_refresh_token() || _refreshing)
+    return false;
+  return !_access[0] || get_age() >= get_refresh_point();
+}
+
+unsigned long TokenManager::get_refresh_wait()
+{
+  if (!has_refresh_token())
+    return ULONG_MAX;
+  if (!_access[0])
+    return 0;
+  uint32_t elapsed = get_age();
+  uint32_t refresh_point = get_refresh_point();
+  return elapsed < refresh_point ? refresh_point - elapsed : 0;
+}
+
+bool TokenManager::begin_refresh()
+{
+  if (_refreshing)
+    return false;
+  _refreshing = true;
+  return true;
+}
@@ -0,0 +1,56 @@
+#ifndef TOKEN_MANAGER_H
+#define TOKEN_MANAGER_H
+
+#include <Arduino.h>
+#include <token_store.h>
+
+// Spotify access tokens are about 300 characters long
+#define TOKEN_ACCESS_MAX_LENGTH 512
+// The access token is refreshed this long before it expires, at the latest after half of its lifetime
+#define TOKEN_REFRESH_AHEAD 300000
+
+/*
+  Access and refresh token of the session in fixed buffers.
+
+  The expiry is kept as the millis() of the grant plus the lifetime, every check compares the
+  unsigned elapsed time with the lifetime. This stays correct across the millis() wraparound as
+  long as a token is younger than 49 days, which the refresh ahead of time guarantees.
+  needs_refresh() turns true TOKEN_REFRESH_AHEAD before the expiry, so the token is renewed in the
+  background between two polls and a call never has to wait for it. begin_refresh() makes the
+  refresh single flight, a nested call finds the refresh in progress and does not start another one.
+*/
+class TokenManager
+{
+private:
+  char _access[TOKEN_ACCESS_MAX_LENGTH + 1] = "";
+  char _refresh[TOKEN_STORE_MAX_LENGTH + 1] = "";
+  uint32_t _granted_at = 0;
+  uint32_t _lifetime = 0;
+  bool _refreshing = false;
+
+  static bool copy(char *dest, size_t size, const char *src);
+  // Truncated to 32 bits, so the subtraction wraps like millis() itself
+  uint32_t get_age() { return millis() - _granted_at; }
+  uint32_t get_refresh_point();
+
+public:
+  // expires_in is the lifetime in seconds as sent by Spotify
+  bool set_access_token(const char *token, uint32_t expires_in);
+  bool set_refresh_token(const char *token);
+  void clear();
+
+  const char *get_access_token() { return _access; }
+  const char *get_refresh_token() { return _refresh; }
+  bool has_access_token() { return _access[0] && !is_expired(); }
+  bool has_refresh_token() { return _refresh[0]; }
+  bool is_expired() { return get_age() >= _lifetime; }
+
+  bool needs_refresh();
+  // Milliseconds until needs_refresh() turns true
+  unsigned long get_refresh_wait();
+  // False if a refresh is already in progress
+  bool begin_refresh();
+  void end_refresh() { _refreshing = false; }
+};
+
+#endif
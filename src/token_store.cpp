@@ -0,0 +1,41 @@
+#include <token_store.h>
+#include <atomic_record.h>
+#include <checksum.h>
+
+// Bumped with every change of the login scope, a token granted for the old scope is not loaded
+// and the device asks for a new login instead of failing every request with 401 or 403
+#define TOKEN_STORE_MAGIC 0x544F4B32 // "TOK2", added user-read-playback-state
+
+bool TokenStore::load(char *refresh_token)
+{
+  AtomicRecord record(TOKEN_STORE_PATH, TOKEN_STORE_MAGIC);
+  size_t length = record.read(refresh_token, TOKEN_STORE_MAX_LENGTH);
+  if (length == 0)
+    return false;
+  refresh_token[length] = '\0';
+  _checksum = fnv1a(refresh_token, length);
+  return true;
+}
+
+bool TokenStore::save(const char *refresh_token)
+{
+  uint16_t length = strlen(refresh_token);
+  if (length == 0 || length > TOKEN_STORE_MAX_LENGTH)
+    return false;
+
+  uint32_t checksum = fnv1a(refresh_token, length);
+  if (checksum == _checksum)
+    return true;
+
+  AtomicRecord record(TOKEN_STORE_PATH, TOKEN_STORE_MAGIC);
+  if (!record.write(refresh_token, length))
+    return false;
+  _checksum = checksum;
+  return true;
+}
+
+void TokenStore::clear()
+{
+  AtomicRecord(TOKEN_STORE_PATH, TOKEN_STORE_MAGIC).remove();
+  _checksum = 0;
+}
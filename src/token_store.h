@@ -0,0 +1,30 @@
+#ifndef TOKEN_STORE_H
+#define TOKEN_STORE_H
+
+#include <Arduino.h>
+
+#define TOKEN_STORE_PATH "/token"
+#define TOKEN_STORE_MAX_LENGTH 512
+
+/*
+  Keeps the Spotify refresh token on flash, so a reboot only needs one refresh request
+  instead of another login through the web interface.
+
+  The record carries a magic number, the length and a checksum of the token and is replaced
+  atomically through a temporary file. Writes are skipped as long as the stored token is
+  unchanged, which is the common case since Spotify mostly keeps the refresh token.
+*/
+class TokenStore
+{
+private:
+  // Checksum of the token on flash, 0 if there is none
+  uint32_t _checksum = 0;
+
+public:
+  // refresh_token needs room for TOKEN_STORE_MAX_LENGTH characters and the terminator
+  bool load(char *refresh_token);
+  bool save(const char *refresh_token);
+  void clear();
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <virtual_sh1106.h>
+#include <string.h>
+
+#define SH1106_I2C_ADDRESS 0x78
+
+VirtualSH1106 *VirtualSH1106::_instance = nullptr;
+
+void VirtualSH1106::attach(u8x8_t *u8x8)
+{
+  _instance = this;
+  memset(_ram, 0, sizeof(_ram));
+  u8x8->byte_cb = u8x8_byte_sw_i2c;
+  u8x8->gpio_and_delay_cb = gpio_and_delay_cb;
+}
+
+uint8_t VirtualSH1106::gpio_and_delay_cb(u8x8_t *, uint8_t msg, uint8_t arg_int, void *)
+{
+  switch (msg)
+  {
+  case U8X8_MSG_GPIO_I2C_CLOCK:
+    _instance->on_lines(arg_int ? 1 : 0, _instance->_sda);
+    break;
+  case U8X8_MSG_GPIO_I2C_DATA:
+    _instance->on_lines(_instance->_scl, arg_int ? 1 : 0);
+    break;
+  default:
+    // Delays and the other pins have no meaning for the model
+    break;
+  }
+  return 1;
+}
+
+void VirtualSH1106::on_lines(uint8_t scl, uint8_t sda)
+{
+  if (_scl && scl && _sda != sda)
+  {
+    // SDA changes while SCL is high are start and stop conditions
+    if (sda)
+      on_stop();
+    else
+      on_start();
+  }
+  else if (!_scl && scl && _addressed)
+  {
+    // Eight data bits are sampled on the rising edge, the ninth is the acknowledge
+    if (_bit_count < 8)
+      _shift = (_shift << 1) | sda;
+    _bit_count++;
+    if (_bit_count == 9)
+    {
+      _bit_count = 0;
+      on_byte(_shift);
+    }
+  }
+  _scl = scl;
+  _sda = sda;
+}
+
+void VirtualSH1106::on_start()
+{
+  _addressed = true;
+  _address_byte = true;
+  _bit_count = 0;
+  _bus_cycles++;
+}
+
+void VirtualSH1106::on_stop()
+{
+  if (_addressed)
+    _transfers++;
+  _addressed = false;
+  _bus_cycles++;
+}
+
+void VirtualSH1106::on_byte(uint8_t value)
+{
+  _bus_cycles += 9;
+  if (!_addressed)
+    return;
+
+  if (_address_byte)
+  {
+    _address_byte = false;
+    _addressed = (value & 0xFE) == SH1106_I2C_ADDRESS;
+    _control_byte = true;
+    return;
+  }
+  if (_control_byte)
+  {
+    // Co = 0: the rest of the transfer is a stream, Co = 1: one byte, then a control byte again
+    _single = value & 0x80;
+    _data = value & 0x40;
+    _control_byte = false;
+    return;
+  }
+  if (_data)
+    data(value);
+  else
+    command(value);
+  if (_single)
+    _control_byte = true;
+}
+
+void VirtualSH1106::command(uint8_t value)
+{
+  if (_pending_args)
+  {
+    if (_pending_command == 0x81)
+      _contrast = value;
+    _pending_args--;
+    return;
+  }
+
+  if (value <= 0x0F)
+    _column = (_column & 0xF0) | value;
+  else if (value <= 0x1F)
+    _column = (_column & 0x0F) | ((value & 0x0F) << 4);
+  else if (value >= 0x40 && value <= 0x7F)
+    _start_line = value & 0x3F;
+  else if (value >= 0xB0 && value <= 0xB7)
+    _page = value & 0x07;
+  else if (value == 0xAE || value == 0xAF)
+    _display_on = value & 1;
+  else if (value == 0xA0 || value == 0xA1)
+    _segment_remap = value & 1;
+  else if (value == 0xC0 || value == 0xC8)
+    _com_reverse = value & 0x08;
+  else if (value == 0xA6 || value == 0xA7)
+    _inverted = value & 1;
+  else if (value == 0x81 || value == 0xA8 || value == 0xAD || value == 0xD3 || value == 0xD5 ||
+           value == 0xD9 || value == 0xDA || value == 0xDB || value == 0x8D)
+  {
+    // Double byte commands, only the contrast is kept
+    _pending_command = value;
+    _pending_args = 1;
+  }
+}
+
+void VirtualSH1106::data(uint8_t value)
+{
+  // The column address stops at the last column, it does not wrap to the next page
+  if (_column < SH1106_RAM_WIDTH)
+    _ram[_page][_column++] = value;
+}
+
+uint8_t VirtualSH1106::get_pixel(uint16_t x, uint16_t y)
+{
+  if (!_display_on || x >= SH1106_WIDTH || y >= SH1106_HEIGHT)
+    return 0;
+
+  // u8g2 sets A1 and C8 for the unflipped view, without them the picture is rotated by 180 degrees
+  uint16_t column = _segment_remap ? x + SH1106_COLUMN_OFFSET : SH1106_COLUMN_OFFSET + SH1106_WIDTH - 1 - x;
+  uint16_t row = _com_reverse ? y : SH1106_HEIGHT - 1 - y;
+  uint16_t line = (row + _start_line) % SH1106_HEIGHT;
+  uint8_t pixel = (_ram[line / 8][column] >> (line % 8)) & 1;
+  return _inverted ? !pixel : pixel;
+}
+
+void VirtualSH1106::get_frame(uint8_t *frame)
+{
+  memset(frame, 0, SH1106_WIDTH * SH1106_HEIGHT / 8);
+  for (uint16_t y = 0; y < SH1106_HEIGHT; y++)
+    for (uint16_t x = 0; x < SH1106_WIDTH; x++)
+      if (get_pixel(x, y))
+        frame[(y / 8) * SH1106_WIDTH + x] |= 1 << (y % 8);
+}
+
+void VirtualSH1106::write_pbm(void (*out)(const char *s))
+{
+  u8x8_capture_write_pbm_pre(SH1106_WIDTH / 8, SH1106_HEIGHT / 8, out);
+  for (uint16_t y = 0; y < SH1106_HEIGHT; y++)
+  {
+    for (uint16_t x = 0; x < SH1106_WIDTH; x++)
+      out(get_pixel(x, y) ? "1" : "0");
+    out("\n");
+  }
+}
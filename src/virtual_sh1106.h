@@ -0,0 +1,91 @@
+#ifndef VIRTUAL_SH1106_H
+#define VIRTUAL_SH1106_H
+
+#include <stdint.h>
+#include <clib/u8x8.h>
+
+// The SH1106 has 132 columns of display RAM, the 128 pixel glass shows columns 2..129
+#define SH1106_RAM_WIDTH 132
+#define SH1106_RAM_PAGES 8
+#define SH1106_COLUMN_OFFSET 2
+#define SH1106_WIDTH 128
+#define SH1106_HEIGHT 64
+
+/*
+  Software model of an SH1106 on the I2C bus, to check and time display transports without
+  the panel.
+
+  attach() routes a u8x8 display through u8x8_byte_sw_i2c and takes over its gpio_and_delay
+  callback. The SCL/SDA levels, there or from on_lines(), are decoded into start, byte and stop
+  events, or these can be fed directly with on_start(), on_byte() and on_stop(). The commands for page and column address,
+  start line, contrast, remap and display on/off are applied to a 132x64 GDDRAM image.
+
+  get_frame() returns what the glass shows in the tile layout of the u8g2 buffer and write_pbm()
+  has the same output as u8g2_WriteBufferPBM(), so both can be compared directly.
+*/
+class VirtualSH1106
+{
+private:
+  static VirtualSH1106 *_instance;
+
+  uint8_t _ram[SH1106_RAM_PAGES][SH1106_RAM_WIDTH] = {};
+  uint8_t _page = 0;
+  uint8_t _column = 0;
+  uint8_t _start_line = 0;
+  uint8_t _contrast = 0x80;
+  bool _display_on = false;
+  bool _inverted = false;
+  bool _segment_remap = false;
+  bool _com_reverse = false;
+
+  // Bus decoder
+  uint8_t _scl = 1;
+  uint8_t _sda = 1;
+  uint8_t _bit_count = 0;
+  uint8_t _shift = 0;
+
+  // Transfer state
+  bool _addressed = false;
+  bool _address_byte = false;
+  bool _control_byte = false;
+  bool _single = false;
+  bool _data = false;
+  uint8_t _pending_command = 0;
+  uint8_t _pending_args = 0;
+
+  uint32_t _bus_cycles = 0;
+  uint32_t _transfers = 0;
+
+  static uint8_t gpio_and_delay_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+  void command(uint8_t value);
+  void data(uint8_t value);
+
+public:
+  void attach(u8x8_t *u8x8);
+
+  // Levels of both lines after a change, decoded into the events below
+  void on_lines(uint8_t scl, uint8_t sda);
+  void on_start();
+  void on_byte(uint8_t value);
+  void on_stop();
+
+  uint8_t get_pixel(uint16_t x, uint16_t y);
+  // Writes SH1106_WIDTH * SH1106_HEIGHT / 8 bytes
+  void get_frame(uint8_t *frame);
+  void write_pbm(void (*out)(const char *s));
+
+  uint8_t get_start_line() { return _start_line; }
+  uint8_t get_contrast() { return _contrast; }
+  bool is_display_on() { return _display_on; }
+
+  // SCL cycles including acknowledge bits, reset once per frame to get the cycles per frame
+  uint32_t get_bus_cycles() { return _bus_cycles; }
+  uint32_t get_transfers() { return _transfers; }
+  void reset_counters()
+  {
+    _bus_cycles = 0;
+    _transfers = 0;
+  }
+};
+
+#endif
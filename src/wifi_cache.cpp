@@ -0,0 +1,33 @@
+#include <wifi_cache.h>
+#include <atomic_record.h>
+
+#define WIFI_CACHE_MAGIC 0x57494631 // "WIF1"
+
+bool WifiCache::load()
+{
+  AtomicRecord record(WIFI_CACHE_PATH, WIFI_CACHE_MAGIC);
+  _valid = record.read(&_record, sizeof(_record)) == sizeof(_record);
+  return _valid;
+}
+
+bool WifiCache::save()
+{
+  Record record;
+  memset(&record, 0, sizeof(record));
+  record.channel = WiFi.channel();
+  memcpy(record.bssid, WiFi.BSSID(), sizeof(record.bssid));
+  record.ip = WiFi.localIP();
+  record.gateway = WiFi.gatewayIP();
+  record.subnet = WiFi.subnetMask();
+  record.dns = WiFi.dnsIP();
+
+  if (_valid && memcmp(&record, &_record, sizeof(record)) == 0)
+    return true;
+
+  AtomicRecord stored(WIFI_CACHE_PATH, WIFI_CACHE_MAGIC);
+  if (!stored.write(&record, sizeof(record)))
+    return false;
+  _record = record;
+  _valid = true;
+  return true;
+}
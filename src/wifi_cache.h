@@ -0,0 +1,45 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define WIFI_CACHE_PATH "/wifi"
+
+/*
+  Connection parameters of the last successful WiFi connection.
+
+  With a known channel and BSSID the ESP8266 skips the scan of all channels, and with a
+  reused address it also skips DHCP, which together saves a few seconds on every boot.
+*/
+class WifiCache
+{
+private:
+  struct Record
+  {
+    int32_t channel;
+    uint8_t bssid[6];
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+  };
+
+  Record _record;
+  bool _valid = false;
+
+public:
+  bool load();
+  // Stores the parameters of the current connection, nothing is written if they did not change
+  bool save();
+  bool is_valid() { return _valid; }
+
+  int32_t get_channel() { return _record.channel; }
+  const uint8_t *get_bssid() { return _record.bssid; }
+  IPAddress get_ip() { return IPAddress(_record.ip); }
+  IPAddress get_gateway() { return IPAddress(_record.gateway); }
+  IPAddress get_subnet() { return IPAddress(_record.subnet); }
+  IPAddress get_dns() { return IPAddress(_record.dns); }
+};
+
+#endif
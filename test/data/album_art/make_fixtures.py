@@ -0,0 +1,25 @@
+# Writes the JPEG fixtures of test_album_art, run with Pillow installed: python3 make_fixtures.py
+from PIL import Image, ImageDraw
+
+def split(size, vertical, mode="L", bright=255, dark=0):
+    image = Image.new(mode, (size, size), dark)
+    box = (size // 2, 0, size, size) if vertical else (0, 0, size, size // 2)
+    ImageDraw.Draw(image).rectangle(box, fill=bright)
+    return image
+
+# Left half black, right half white, no chroma subsampling
+split(96, True, "RGB", (255, 255, 255), (0, 0, 0)).save("baseline_444.jpg", quality=90, subsampling=0)
+# Top half white, bottom half black, 4:2:0 like most covers
+split(96, False, "RGB", (255, 255, 255), (0, 0, 0)).save("subsampled_420.jpg", quality=90, subsampling=2)
+# Single component, horizontal gradient from black to white
+gradient = Image.new("L", (64, 64))
+gradient.putdata([x * 255 // 63 for y in range(64) for x in range(64)])
+gradient.save("grayscale.jpg", quality=90)
+# Restart marker after every MCU
+split(96, True, "RGB", (255, 255, 255), (0, 0, 0)).save("restart.jpg", quality=90, subsampling=2, restart_marker_blocks=1)
+# Large enough for the DC only path, white top left quadrant
+large = Image.new("RGB", (640, 640), (0, 0, 0))
+ImageDraw.Draw(large).rectangle((0, 0, 319, 319), fill=(255, 255, 255))
+large.save("large_dc.jpg", quality=85, subsampling=2)
+# Progressive JPEGs are not supported and have to be rejected
+split(96, True, "RGB", (255, 255, 255), (0, 0, 0)).save("progressive.jpg", quality=90, progressive=True)
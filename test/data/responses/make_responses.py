@@ -0,0 +1,154 @@
+# Writes the anonymized Web API payloads of test_response_parser and test_gzip_stream: python3 make_responses.py
+# The layout follows the recorded responses: pretty printed with " : " and the field order of Spotify,
+# ids, urls and names are made up. Every payload is also written gzip encoded like the API sends it.
+import gzip
+import json
+import random
+
+MARKETS = ["AD", "AE", "AG", "AL", "AM", "AO", "AR", "AT", "AU", "AZ", "BA", "BB", "BD", "BE", "BF", "BG", "BH", "BI",
+           "BJ", "BN", "BO", "BR", "BS", "BT", "BW", "BY", "BZ", "CA", "CD", "CG", "CH", "CI", "CL", "CM", "CO", "CR",
+           "CV", "CW", "CY", "CZ", "DE", "DJ", "DK", "DM", "DO", "DZ", "EC", "EE", "EG", "ES", "ET", "FI", "FJ", "FM",
+           "FR", "GA", "GB", "GD", "GE", "GH", "GM", "GN", "GQ", "GR", "GT", "GW", "GY", "HK", "HN", "HR", "HT", "HU",
+           "ID", "IE", "IL", "IN", "IQ", "IS", "IT", "JM", "JO", "JP", "KE", "KG", "KH", "KI", "KM", "KN", "KR", "KW",
+           "KZ", "LA", "LB", "LC", "LI", "LK", "LR", "LS", "LT", "LU", "LV", "LY", "MA", "MC", "MD", "ME", "MG", "MH",
+           "MK", "ML", "MN", "MO", "MR", "MT", "MU", "MV", "MW", "MX", "MY", "MZ", "NA", "NE", "NG", "NI", "NL", "NO",
+           "NP", "NR", "NZ", "OM", "PA", "PE", "PG", "PH", "PK", "PL", "PS", "PT", "PW", "PY", "QA", "RO", "RS", "RW",
+           "SA", "SB", "SC", "SE", "SG", "SI", "SK", "SL", "SM", "SN", "SR", "ST", "SV", "SZ", "TD", "TG", "TH", "TJ",
+           "TL", "TN", "TO", "TR", "TT", "TV", "TW", "TZ", "UA", "UG", "US", "UY", "UZ", "VC", "VE", "VN", "VU", "WS",
+           "XK", "ZA", "ZM", "ZW"]
+
+
+def uid(seed):
+    return ("%022x" % (seed * 0x9E3779B97F4A7C15 % (1 << 88)))[:22]
+
+
+def artist(name, seed):
+    return {
+        "external_urls": {"spotify": "https://open.spotify.com/artist/" + uid(seed)},
+        "href": "https://api.spotify.com/v1/artists/" + uid(seed),
+        "id": uid(seed),
+        "name": name,
+        "type": "artist",
+        "uri": "spotify:artist:" + uid(seed),
+    }
+
+
+def images(seed):
+    return [{"height": size, "url": "https://i.scdn.co/image/ab67616d%08x%04d" % (seed, size), "width": size}
+            for size in (640, 300, 64)]
+
+
+def track(name, album, artists, seed, markets):
+    artist_objects = [artist(a, seed * 10 + i) for i, a in enumerate(artists)]
+    return {
+        "album": {
+            "album_type": "album",
+            "artists": artist_objects[:1],
+            "available_markets": markets,
+            "external_urls": {"spotify": "https://open.spotify.com/album/" + uid(seed + 1)},
+            "href": "https://api.spotify.com/v1/albums/" + uid(seed + 1),
+            "id": uid(seed + 1),
+            "images": images(seed),
+            "name": album,
+            "release_date": "1997-05-21",
+            "release_date_precision": "day",
+            "total_tracks": 12,
+            "type": "album",
+            "uri": "spotify:album:" + uid(seed + 1),
+        },
+        "artists": artist_objects,
+        "available_markets": markets,
+        "disc_number": 1,
+        "duration_ms": 383493 + seed,
+        "explicit": False,
+        "external_ids": {"isrc": "GBAYE97000%02d" % (seed % 100)},
+        "external_urls": {"spotify": "https://open.spotify.com/track/" + uid(seed + 2)},
+        "href": "https://api.spotify.com/v1/tracks/" + uid(seed + 2),
+        "id": uid(seed + 2),
+        "is_local": False,
+        "name": name,
+        "popularity": 77,
+        "preview_url": None,
+        "track_number": 2,
+        "type": "track",
+        "uri": "spotify:track:" + uid(seed + 2),
+    }
+
+
+def player(item, playing=True, item_type="track"):
+    return {
+        "device": {
+            "id": uid(99),
+            "is_active": True,
+            "is_private_session": False,
+            "is_restricted": False,
+            "name": "Living Room",
+            "supports_volume": True,
+            "type": "Speaker",
+            "volume_percent": 42,
+        },
+        "shuffle_state": False,
+        "smart_shuffle": False,
+        "repeat_state": "off",
+        "timestamp": 1729260000000,
+        "context": {
+            "external_urls": {"spotify": "https://open.spotify.com/playlist/" + uid(98)},
+            "href": "https://api.spotify.com/v1/playlists/" + uid(98),
+            "type": "playlist",
+            "uri": "spotify:playlist:" + uid(98),
+        },
+        "progress_ms": 51234,
+        "item": item,
+        "currently_playing_type": item_type,
+        "actions": {"disallows": {"resuming": True}},
+        "is_playing": playing,
+    }
+
+
+def write(name, payload):
+    data = json.dumps(payload, indent=2, separators=(",", " : "), ensure_ascii=False).encode("utf-8")
+    with open(name, "wb") as f:
+        f.write(data)
+    with open(name + ".gz", "wb") as f:
+        f.write(gzip.compress(data, compresslevel=6, mtime=0))
+
+
+write("me.json", {
+    "country": "DE",
+    "display_name": "Jane Doe",
+    "explicit_content": {"filter_enabled": False, "filter_locked": False},
+    "external_urls": {"spotify": "https://open.spotify.com/user/" + uid(1)},
+    "followers": {"href": None, "total": 12},
+    "href": "https://api.spotify.com/v1/users/" + uid(1),
+    "id": uid(1),
+    "images": [],
+    "product": "premium",
+    "type": "user",
+    "uri": "spotify:user:" + uid(1),
+})
+# A track which is only released in a few markets
+write("player_track.json", player(track("Paranoid Android", "OK Computer", ["Radiohead"], 1, ["DE", "GB", "US"])))
+# Every market twice, once for the album and once for the track, most of the body is never used
+write("player_markets.json", player(track("Paranoid Android", "OK Computer", ["Radiohead"], 2, MARKETS)))
+# A long artist array in front of the track name, and UTF-8 texts
+write("player_many_artists.json", player(track("Hoppípolla", "Takk...", ["Sigur Rós"] + ["Guest Artist %d" % i for i in range(11)],
+                                               3, MARKETS)))
+# Podcasts come without item unless additional_types=episode is requested
+write("player_podcast.json", player(None, True, "episode"))
+write("queue.json", {
+    "currently_playing": track("Paranoid Android", "OK Computer", ["Radiohead"], 4, MARKETS),
+    "queue": [track("Karma Police", "OK Computer", ["Radiohead"], 5, MARKETS)] +
+             [track("Track %d" % i, "Album %d" % i, ["Artist %d" % i], 10 + i, MARKETS) for i in range(4)],
+})
+write("queue_empty.json", {
+    "currently_playing": track("Paranoid Android", "OK Computer", ["Radiohead"], 6, MARKETS),
+    "queue": [],
+})
+# The same 10000 random characters in the album and in the track, the second copy is a back reference
+# beyond the 8 KB window of GzipStream
+random.seed(1)
+notes = "".join(random.choice("0123456789abcdef") for _ in range(10000))
+far = track("Paranoid Android", "OK Computer", ["Radiohead"], 7, ["DE", "GB", "US"])
+far["album"] = dict(list(far["album"].items())[:3] + [("notes", notes)] + list(far["album"].items())[3:])
+far = dict(list(far.items())[:3] + [("notes", notes)] + list(far.items())[3:])
+write("player_far_reference.json", player(far))
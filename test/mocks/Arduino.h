@@ -0,0 +1,375 @@
+#ifndef MOCK_ARDUINO_H
+#define MOCK_ARDUINO_H
+
+/*
+  Host stand-in for the parts of the ESP8266 Arduino core the modules use, for the native tests.
+
+  Time only moves when a test calls mock::advance_us() (or mock::set_us()), unless mock::real_time
+  is set, then millis() and micros() follow the host clock. Pins, interrupts, timer1 and the GPIO
+  enable registers are plain state which the tests can drive and observe.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <memory>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 3
+#define RISING 1
+#define FALLING 2
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define F(x) x
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+namespace mock
+{
+inline bool real_time = false;
+inline uint32_t now_us = 0;
+inline uint32_t now_ms = 0;
+// Sub millisecond rest of the manual clock
+inline uint32_t rest_us = 0;
+
+inline void advance_us(uint32_t us)
+{
+  now_us += us;
+  rest_us += us;
+  now_ms += rest_us / 1000;
+  rest_us %= 1000;
+}
+
+inline void set_ms(uint32_t ms)
+{
+  now_ms = ms;
+  now_us = ms * 1000;
+  rest_us = 0;
+}
+
+inline uint64_t host_us()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+// Pin levels, pin modes and the attached interrupt handlers, indexed by GPIO number
+inline uint8_t pin_level[17] = {};
+inline uint8_t pin_mode[17] = {};
+inline void (*pin_isr[17])() = {};
+
+// Sets the level of an input pin and runs its interrupt handler like the hardware would
+inline void set_pin(uint8_t pin, uint8_t level)
+{
+  pin_level[pin] = level;
+  if (pin_isr[pin])
+    pin_isr[pin]();
+}
+
+// Called by yield() and delay(), lets a test run background work while the code waits
+inline void (*on_yield)() = nullptr;
+
+// timer1: armed by timer1_write(), a test fires it with fire_timer1()
+inline void (*timer1_isr)() = nullptr;
+inline bool timer1_armed = false;
+inline uint32_t timer1_ticks = 0;
+
+inline bool fire_timer1()
+{
+  if (!timer1_armed || !timer1_isr)
+    return false;
+  timer1_armed = false;
+  timer1_isr();
+  return true;
+}
+
+// Output enable bits of GPIO 0..15, an enabled open drain pin pulls its line low
+inline uint32_t gpio_enable = 0;
+inline void (*on_gpio)(uint32_t enable) = nullptr;
+
+inline uint32_t random_state = 1;
+} // namespace mock
+
+inline unsigned long millis()
+{
+  return mock::real_time ? (uint32_t)(mock::host_us() / 1000) : mock::now_ms;
+}
+
+inline unsigned long micros()
+{
+  return mock::real_time ? (uint32_t)mock::host_us() : mock::now_us;
+}
+
+inline void yield()
+{
+  if (mock::on_yield)
+    mock::on_yield();
+}
+
+inline void delay(unsigned long ms)
+{
+  if (!mock::real_time)
+    mock::advance_us(ms * 1000);
+  yield();
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+  if (!mock::real_time)
+    mock::advance_us(us);
+}
+
+inline int digitalRead(uint8_t pin) { return mock::pin_level[pin]; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { mock::pin_level[pin] = level; }
+inline void pinMode(uint8_t pin, uint8_t mode) { mock::pin_mode[pin] = mode; }
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int) { mock::pin_isr[pin] = isr; }
+inline void detachInterrupt(uint8_t pin) { mock::pin_isr[pin] = nullptr; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline long random(long max_value)
+{
+  mock::random_state = mock::random_state * 1103515245u + 12345u;
+  return max_value > 0 ? (long)((mock::random_state >> 8) % (uint32_t)max_value) : 0;
+}
+
+inline long random(long min_value, long max_value) { return min_value + random(max_value - min_value); }
+
+class String
+{
+private:
+  std::string _s;
+
+public:
+  String() {}
+  String(const char *s) : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  explicit String(int v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long v) : _s(std::to_string(v)) {}
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    size_t p = _s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned int from, unsigned int to) const { return _s.substr(from, to - from); }
+  String &operator+=(const String &o)
+  {
+    _s += o._s;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    _s += c;
+    return *this;
+  }
+  bool operator==(const String &o) const { return _s == o._s; }
+  bool operator!=(const String &o) const { return _s != o._s; }
+  friend String operator+(const String &a, const String &b) { return a._s + b._s; }
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const char *s) { return write(s); }
+  size_t println(const char *s = "") { return write(s) + write("\n"); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return n > 0 ? write((const uint8_t *)buffer, strlen(buffer)) : 0;
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print
+{
+protected:
+  unsigned long _timeout = 1000;
+
+  // The host streams have all their data at once, so a read never has to wait
+  int timedRead() { return read(); }
+
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() { return _timeout; }
+
+  virtual size_t readBytes(char *buffer, size_t length)
+  {
+    size_t count = 0;
+    while (count < length)
+    {
+      int c = timedRead();
+      if (c < 0)
+        break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+
+  bool find(const char *target)
+  {
+    size_t length = strlen(target);
+    size_t index = 0;
+    int c;
+    while ((c = timedRead()) >= 0)
+    {
+      if (c == target[index])
+      {
+        if (++index == length)
+          return true;
+      }
+      else
+        index = c == target[0] ? 1 : 0;
+    }
+    return false;
+  }
+};
+
+// Stream over a buffer in memory, optionally handing out at most chunk bytes per available()
+class MemoryStream : public Stream
+{
+private:
+  const uint8_t *_data;
+  size_t _size;
+  size_t _pos = 0;
+
+public:
+  MemoryStream(const void *data, size_t size) : _data((const uint8_t *)data), _size(size) {}
+  void rewind() { _pos = 0; }
+  size_t position() { return _pos; }
+
+  int available() override { return (int)(_size - _pos); }
+  int read() override { return _pos < _size ? _data[_pos++] : -1; }
+  int peek() override { return _pos < _size ? _data[_pos] : -1; }
+  size_t readBytes(char *buffer, size_t length) override
+  {
+    size_t n = std::min(length, _size - _pos);
+    memcpy(buffer, _data + _pos, n);
+    _pos += n;
+    return n;
+  }
+  using Stream::readBytes;
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+  // Set to false to keep the logs of the modules out of the test output
+  bool echo = true;
+
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return echo ? fwrite(&c, 1, 1, stdout) : 1; }
+  size_t write(const uint8_t *buffer, size_t size) override { return echo ? fwrite(buffer, 1, size, stdout) : size; }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+inline HardwareSerial Serial;
+
+class EspClass
+{
+public:
+  uint32_t getCycleCount() { return (uint32_t)(mock::host_us() * 80); }
+  uint32_t getFreeHeap() { return 40000; }
+};
+
+inline EspClass ESP;
+
+inline uint32_t esp_get_cycle_count()
+{
+  return ESP.getCycleCount();
+}
+
+// CPU2X is the 160 MHz flag of the ESP8266, the host runs at 80 MHz
+inline volatile uint32_t CPU2X = 0;
+
+// Writes to the GPIO enable set and clear registers change mock::gpio_enable
+class GpioEnableRegister
+{
+private:
+  bool _set;
+
+public:
+  explicit GpioEnableRegister(bool set) : _set(set) {}
+  GpioEnableRegister &operator=(uint32_t mask)
+  {
+    if (_set)
+      mock::gpio_enable |= mask;
+    else
+      mock::gpio_enable &= ~mask;
+    if (mock::on_gpio)
+      mock::on_gpio(mock::gpio_enable);
+    return *this;
+  }
+};
+
+inline GpioEnableRegister GPES(true);
+inline GpioEnableRegister GPEC(false);
+// The output latch is not modelled, open drain pins only use the enable register
+inline volatile uint32_t GPOS = 0;
+inline volatile uint32_t GPOC = 0;
+
+typedef void (*timercallback)(void);
+#define TIM_DIV1 0
+#define TIM_DIV16 1
+#define TIM_DIV256 3
+#define TIM_EDGE 0
+#define TIM_LEVEL 1
+#define TIM_SINGLE 0
+#define TIM_LOOP 1
+
+inline void timer1_attachInterrupt(timercallback isr) { mock::timer1_isr = isr; }
+inline void timer1_detachInterrupt() { mock::timer1_isr = nullptr; }
+inline void timer1_enable(uint8_t, uint8_t, uint8_t) {}
+inline void timer1_disable() { mock::timer1_armed = false; }
+inline void timer1_write(uint32_t ticks)
+{
+  mock::timer1_ticks = ticks;
+  mock::timer1_armed = true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef MOCK_LITTLEFS_H
+#define MOCK_LITTLEFS_H
+
+/*
+  LittleFS backed by a directory of the host, the flash stand-in of the native tests.
+
+  mock::fs_reset() starts with an empty flash. mock::fs_write_budget limits the number of bytes
+  which can still be written, the write which exceeds it stops half way like at a power loss.
+*/
+
+#include <Arduino.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum SeekMode
+{
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+namespace mock
+{
+inline std::string fs_root;
+inline long fs_write_budget = -1;
+
+inline void fs_reset()
+{
+  if (fs_root.empty())
+  {
+    char path[] = "/tmp/littlefs-XXXXXX";
+    fs_root = mkdtemp(path);
+  }
+  DIR *dir = opendir(fs_root.c_str());
+  if (dir)
+  {
+    while (dirent *entry = readdir(dir))
+    {
+      if (entry->d_name[0] != '.')
+        unlink((fs_root + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+  }
+  fs_write_budget = -1;
+}
+
+inline std::string fs_path(const char *path)
+{
+  if (fs_root.empty())
+    fs_reset();
+  return fs_root + path;
+}
+} // namespace mock
+
+class File : public Stream
+{
+private:
+  std::shared_ptr<FILE> _file;
+
+public:
+  File() {}
+  explicit File(FILE *file) : _file(file, fclose) {}
+
+  explicit operator bool() const { return (bool)_file; }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    if (!_file)
+      return 0;
+    if (mock::fs_write_budget >= 0 && (long)size > mock::fs_write_budget)
+      size = mock::fs_write_budget;
+    if (mock::fs_write_budget >= 0)
+      mock::fs_write_budget -= size;
+    return fwrite(buffer, 1, size, _file.get());
+  }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  using Print::write;
+
+  int available() override { return _file ? (int)(size() - position()) : 0; }
+  int read() override { return _file ? fgetc(_file.get()) : -1; }
+  int peek() override
+  {
+    int c = read();
+    if (c >= 0)
+      ungetc(c, _file.get());
+    return c;
+  }
+  size_t read(uint8_t *buffer, size_t size) { return _file ? fread(buffer, 1, size, _file.get()) : 0; }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet)
+  {
+    return _file && fseek(_file.get(), pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+  }
+  size_t position() const { return _file ? ftell(_file.get()) : 0; }
+  size_t size() const
+  {
+    struct stat st;
+    return _file && fstat(fileno(_file.get()), &st) == 0 ? st.st_size : 0;
+  }
+  void close() { _file.reset(); }
+};
+
+class FS
+{
+public:
+  bool begin() { return true; }
+  void end() {}
+  bool format()
+  {
+    mock::fs_reset();
+    return true;
+  }
+  File open(const char *path, const char *mode)
+  {
+    // LittleFS opens "r+" and "w+" like stdio, binary mode makes no difference on the host
+    FILE *file = fopen(mock::fs_path(path).c_str(), mode);
+    return file ? File(file) : File();
+  }
+  File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+  bool exists(const char *path) { return access(mock::fs_path(path).c_str(), F_OK) == 0; }
+  bool remove(const char *path) { return unlink(mock::fs_path(path).c_str()) == 0; }
+  bool rename(const char *from, const char *to)
+  {
+    return ::rename(mock::fs_path(from).c_str(), mock::fs_path(to).c_str()) == 0;
+  }
+};
+
+inline FS LittleFS;
+
+#endif
@@ -0,0 +1,128 @@
+# Converts the u8x8 5x8 font of the vendored library into the u8g2 font format and writes
+# view_test_font.h, so the host tests can draw text without the large u8g2_fonts.c.
+# Run from the project directory: python3 test/mocks/make_view_test_font.py
+import re
+
+ADVANCE = 6
+# Row of the 8x8 tile on the baseline, the row below is for descenders
+BASELINE_ROW = 6
+
+
+def read_u8x8_font(name):
+    source = open("lib/U8g2/src/clib/u8x8_fonts.c", encoding="latin-1").read()
+    body = re.search(r"\b%s\[\d+\][^=]*=\s*((?:\s*\"(?:[^\"\\]|\\.)*\")+)\s*;" % name, source).group(1)
+    data = bytearray()
+    for literal in re.findall(r"\"((?:[^\"\\]|\\.)*)\"", body):
+        i = 0
+        while i < len(literal):
+            if literal[i] != "\\":
+                data.append(ord(literal[i]))
+                i += 1
+                continue
+            octal = re.match(r"[0-7]{1,3}", literal[i + 1:])
+            if octal:
+                data.append(int(octal.group(0), 8))
+                i += 1 + len(octal.group(0))
+            else:
+                data.append({"n": 10, "t": 9, "r": 13}.get(literal[i + 1], ord(literal[i + 1])))
+                i += 2
+    # The terminating zero of the string is the last byte of the font
+    data.append(0)
+    return data
+
+
+class Bits:
+    def __init__(self):
+        self.data = bytearray()
+        self.position = 0
+
+    def add(self, value, count):
+        for bit in range(count):
+            if self.position % 8 == 0:
+                self.data.append(0)
+            if value >> bit & 1:
+                self.data[-1] |= 1 << (self.position % 8)
+            self.position += 1
+
+
+def signed(value, count):
+    return value + (1 << (count - 1))
+
+
+def encode_glyph(code, rows):
+    # rows: 8 strings of 8 pixels, cropped to the bounding box of the set pixels
+    filled = [y for y in range(8) if "1" in rows[y]]
+    bits = Bits()
+    if not filled:
+        for value, count in ((0, 4), (0, 4), (signed(0, 4), 4), (signed(0, 4), 4), (signed(ADVANCE, 4), 4)):
+            bits.add(value, count)
+        return bytes([code, 2 + len(bits.data)]) + bits.data, None
+    columns = [x for x in range(8) if any(rows[y][x] == "1" for y in range(8))]
+    x0, x1, y0, y1 = columns[0], columns[-1], filled[0], filled[-1]
+    width, height = x1 - x0 + 1, y1 - y0 + 1
+    bits.add(width, 4)
+    bits.add(height, 4)
+    bits.add(signed(x0, 4), 4)
+    bits.add(signed(BASELINE_ROW - y1, 4), 4)
+    bits.add(signed(ADVANCE, 4), 4)
+    pixels = "".join(rows[y][x0:x1 + 1] for y in range(y0, y1 + 1))
+    # Runs of background and foreground pixels, at most 15 each
+    i = 0
+    while i < len(pixels):
+        zeros = 0
+        while i < len(pixels) and pixels[i] == "0" and zeros < 15:
+            zeros += 1
+            i += 1
+        ones = 0
+        while i < len(pixels) and pixels[i] == "1" and ones < 15:
+            ones += 1
+            i += 1
+        bits.add(zeros, 4)
+        bits.add(ones, 4)
+        bits.add(0, 1)
+    return bytes([code, 2 + len(bits.data)]) + bits.data, (x0, x1, y0, y1)
+
+
+def main():
+    font = read_u8x8_font("u8x8_font_5x8_f")
+    first, last = font[0], font[1]
+    glyphs = bytearray()
+    boxes = {}
+    upper_a = lower_a = 0
+    for code in range(first, last + 1):
+        tile = font[4 + (code - first) * 8:4 + (code - first + 1) * 8]
+        rows = ["".join("1" if tile[x] >> y & 1 else "0" for x in range(8)) for y in range(8)]
+        if code == ord("A"):
+            upper_a = len(glyphs)
+        if code == ord("a"):
+            lower_a = len(glyphs)
+        glyph, box = encode_glyph(code, rows)
+        glyphs += glyph
+        if box:
+            boxes[code] = box
+    glyphs += bytes([0, 0])
+    unicode_table = len(glyphs)
+    # Lookup table with a single entry and an empty list of unicode glyphs
+    glyphs += bytes([0, 4, 0xFF, 0xFF, 0, 0])
+
+    ascent = lambda c: BASELINE_ROW - boxes[c][2] + 1
+    descent = lambda c: BASELINE_ROW - boxes[c][3]
+    header = bytes([
+        last - first + 1, 0, 4, 4,
+        4, 4, 4, 4, 4,
+        max(b[1] - b[0] + 1 for b in boxes.values()), max(b[3] - b[2] + 1 for b in boxes.values()),
+        min(b[0] for b in boxes.values()) & 0xFF, min(BASELINE_ROW - b[3] for b in boxes.values()) & 0xFF,
+        ascent(ord("A")), descent(ord("g")) & 0xFF, ascent(ord("(")), descent(ord("(")) & 0xFF,
+        upper_a >> 8, upper_a & 0xFF, lower_a >> 8, lower_a & 0xFF, unicode_table >> 8, unicode_table & 0xFF])
+    data = header + glyphs
+
+    with open("test/mocks/view_test_font.h", "w") as out:
+        out.write("// Generated by make_view_test_font.py from u8x8_font_5x8_f, do not edit\n")
+        out.write("#ifndef VIEW_TEST_FONT_H\n#define VIEW_TEST_FONT_H\n\n#include <stdint.h>\n\n")
+        out.write("inline const uint8_t view_test_font[%d] = {\n" % len(data))
+        for i in range(0, len(data), 16):
+            out.write("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",\n")
+        out.write("};\n\n#endif\n")
+
+
+main()
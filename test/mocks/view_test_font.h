@@ -0,0 +1,170 @@
+// Generated by make_view_test_font.py from u8x8_font_5x8_f, do not edit
+#ifndef VIEW_TEST_FONT_H
+#define VIEW_TEST_FONT_H
+
+#include <stdint.h>
+
+inline const uint8_t view_test_font[2546] = {
+  0xe0, 0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x05, 0x08, 0x00, 0xff, 0x06, 0xff, 0x06,
+  0x00, 0x01, 0x8b, 0x03, 0x16, 0x09, 0xd5, 0x20, 0x05, 0x00, 0x88, 0x0e, 0x21, 0x07, 0x61, 0x8a,
+  0x0e, 0x24, 0x02, 0x22, 0x09, 0x33, 0xb9, 0x0e, 0x21, 0x44, 0x88, 0x08, 0x23, 0x14, 0x75, 0x88,
+  0x1e, 0x21, 0x82, 0x84, 0x08, 0x51, 0x22, 0x44, 0x88, 0x12, 0x21, 0x82, 0x84, 0x08, 0x01, 0x00,
+  0x24, 0x10, 0x75, 0x88, 0x2e, 0x61, 0x46, 0x84, 0x08, 0x33, 0x26, 0x44, 0x88, 0x31, 0x41, 0x00,
+  0x25, 0x0d, 0x53, 0x99, 0x0e, 0x41, 0x42, 0x84, 0x08, 0x11, 0x22, 0x48, 0x00, 0x26, 0x12, 0x74,
+  0x88, 0x1e, 0x41, 0x42, 0x84, 0x08, 0x11, 0x24, 0x48, 0x88, 0x10, 0x21, 0x82, 0x84, 0x08, 0x27,
+  0x06, 0x31, 0xba, 0x0e, 0x03, 0x28, 0x0b, 0x62, 0x89, 0x1e, 0x22, 0x42, 0x84, 0x08, 0x12, 0x00,
+  0x29, 0x0c, 0x62, 0x89, 0x0e, 0x41, 0x42, 0x84, 0x08, 0x21, 0x02, 0x00, 0x2a, 0x0d, 0x54, 0x88,
+  0x0e, 0x41, 0x42, 0x88, 0x20, 0x21, 0x22, 0x48, 0x00, 0x2b, 0x0c, 0x55, 0x88, 0x2e, 0x81, 0x82,
+  0x14, 0x09, 0x14, 0x04, 0x00, 0x2c, 0x09, 0x33, 0x79, 0x1e, 0x22, 0x42, 0x04, 0x01, 0x2d, 0x06,
+  0x14, 0xa8, 0x0e, 0x04, 0x2e, 0x09, 0x33, 0x79, 0x1e, 0x21, 0x46, 0x84, 0x00, 0x2f, 0x0d, 0x64,
+  0x88, 0x3e, 0x61, 0x82, 0x04, 0x09, 0x12, 0x26, 0x0c, 0x00, 0x30, 0x0e, 0x63, 0x89, 0x1e, 0x21,
+  0x42, 0x88, 0x10, 0x21, 0x22, 0x44, 0x08, 0x00, 0x31, 0x0c, 0x63, 0x89, 0x1e, 0x21, 0x84, 0x04,
+  0x09, 0x12, 0x62, 0x00, 0x32, 0x0d, 0x64, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x09, 0x21, 0x22, 0x0c,
+  0x01, 0x33, 0x0d, 0x64, 0x88, 0x0e, 0x44, 0x82, 0x08, 0x12, 0x12, 0x42, 0x04, 0x00, 0x34, 0x0e,
+  0x64, 0x88, 0x2e, 0x41, 0x44, 0x84, 0x08, 0x41, 0x24, 0x4c, 0x08, 0x00, 0x35, 0x0c, 0x64, 0x88,
+  0x0e, 0x65, 0x06, 0x09, 0x09, 0x21, 0x02, 0x00, 0x36, 0x0e, 0x64, 0x88, 0x1e, 0x22, 0xc2, 0x8c,
+  0x08, 0x22, 0x24, 0x84, 0x08, 0x00, 0x37, 0x0d, 0x64, 0x88, 0x0e, 0x64, 0x82, 0x84, 0x09, 0x12,
+  0x26, 0x08, 0x00, 0x38, 0x0f, 0x64, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x10, 0x11, 0x44, 0x48, 0x08,
+  0x11, 0x00, 0x39, 0x0e, 0x64, 0x88, 0x1e, 0x22, 0x82, 0x08, 0x09, 0x31, 0x26, 0x84, 0x08, 0x00,
+  0x3a, 0x07, 0x52, 0x89, 0x0e, 0x44, 0x08, 0x3b, 0x0c, 0x63, 0x79, 0x1e, 0x22, 0x04, 0x89, 0x08,
+  0x11, 0x04, 0x00, 0x3c, 0x0c, 0x63, 0x89, 0x2e, 0x21, 0x42, 0x04, 0x09, 0x13, 0x26, 0x00, 0x3d,
+  0x07, 0x34, 0x98, 0x0e, 0x84, 0x08, 0x3e, 0x0d, 0x63, 0x89, 0x0e, 0x61, 0xc2, 0x04, 0x09, 0x11,
+  0x22, 0x08, 0x00, 0x3f, 0x0d, 0x63, 0x89, 0x1e, 0x21, 0x42, 0x04, 0x09, 0x11, 0x2a, 0x04, 0x00,
+  0x40, 0x12, 0x85, 0x78, 0x2e, 0x42, 0x82, 0x08, 0x19, 0x11, 0x42, 0x44, 0x08, 0x21, 0x41, 0x42,
+  0x89, 0x00, 0x41, 0x0c, 0x64, 0x88, 0x1e, 0x22, 0x82, 0x08, 0x31, 0x22, 0x24, 0x00, 0x42, 0x0d,
+  0x64, 0x88, 0x0e, 0x23, 0x82, 0x90, 0x08, 0x22, 0x84, 0x04, 0x00, 0x43, 0x0e, 0x64, 0x88, 0x1e,
+  0x22, 0x82, 0x88, 0x09, 0x13, 0x24, 0x84, 0x08, 0x00, 0x44, 0x0d, 0x64, 0x88, 0x0e, 0x23, 0x82,
+  0x08, 0x11, 0x22, 0x84, 0x04, 0x00, 0x45, 0x0b, 0x64, 0x88, 0x0e, 0x65, 0x46, 0x84, 0x09, 0x43,
+  0x00, 0x46, 0x0c, 0x64, 0x88, 0x0e, 0x65, 0x46, 0x84, 0x09, 0x13, 0x06, 0x00, 0x47, 0x0e, 0x64,
+  0x88, 0x1e, 0x22, 0x82, 0x88, 0x09, 0x31, 0x24, 0x84, 0x08, 0x00, 0x48, 0x0c, 0x64, 0x88, 0x0e,
+  0x41, 0x84, 0x18, 0x11, 0x22, 0x24, 0x00, 0x49, 0x0c, 0x63, 0x89, 0x0e, 0x23, 0x82, 0x04, 0x09,
+  0x12, 0x62, 0x00, 0x4a, 0x0e, 0x64, 0x88, 0x1e, 0x43, 0xc2, 0x84, 0x09, 0x11, 0x22, 0x48, 0x10,
+  0x00, 0x4b, 0x10, 0x64, 0x88, 0x0e, 0x41, 0x44, 0x84, 0x10, 0x12, 0x22, 0x44, 0x88, 0x10, 0x41,
+  0x02, 0x4c, 0x0c, 0x64, 0x88, 0x0e, 0x61, 0xc2, 0x84, 0x09, 0x13, 0x86, 0x00, 0x4d, 0x0b, 0x64,
+  0x88, 0x0e, 0x41, 0x94, 0x08, 0x11, 0x12, 0x00, 0x4e, 0x0c, 0x64, 0x88, 0x0e, 0x41, 0x46, 0x98,
+  0x18, 0x31, 0x24, 0x00, 0x4f, 0x0e, 0x64, 0x88, 0x1e, 0x22, 0x82, 0x08, 0x11, 0x22, 0x24, 0x84,
+  0x08, 0x00, 0x50, 0x0d, 0x64, 0x88, 0x0e, 0x23, 0x82, 0x08, 0x21, 0x11, 0x26, 0x0c, 0x00, 0x51,
+  0x0e, 0x74, 0x78, 0x1e, 0x22, 0x82, 0x08, 0x19, 0x21, 0x42, 0x84, 0xa0, 0x00, 0x52, 0x0d, 0x64,
+  0x88, 0x0e, 0x23, 0x82, 0x08, 0x21, 0x11, 0x44, 0x48, 0x00, 0x53, 0x0f, 0x64, 0x88, 0x1e, 0x22,
+  0x82, 0x84, 0x08, 0x14, 0x22, 0x48, 0x08, 0x11, 0x00, 0x54, 0x0d, 0x63, 0x89, 0x0e, 0x23, 0x82,
+  0x04, 0x09, 0x12, 0x24, 0x04, 0x00, 0x55, 0x0e, 0x64, 0x88, 0x0e, 0x41, 0x84, 0x08, 0x11, 0x22,
+  0x24, 0x84, 0x08, 0x00, 0x56, 0x0e, 0x64, 0x88, 0x0e, 0x41, 0x84, 0x08, 0x11, 0x12, 0x42, 0x88,
+  0x08, 0x00, 0x57, 0x0b, 0x64, 0x88, 0x0e, 0x41, 0x84, 0x08, 0x51, 0x12, 0x00, 0x58, 0x0e, 0x64,
+  0x88, 0x0e, 0x41, 0x84, 0x84, 0x10, 0x22, 0x22, 0x88, 0x90, 0x00, 0x59, 0x0f, 0x65, 0x88, 0x0e,
+  0x61, 0xc4, 0x84, 0x08, 0x11, 0x26, 0x50, 0xa0, 0x20, 0x00, 0x5a, 0x0c, 0x64, 0x88, 0x0e, 0x64,
+  0x82, 0x04, 0x09, 0x12, 0x86, 0x00, 0x5b, 0x0b, 0x63, 0x89, 0x0e, 0x44, 0x82, 0x04, 0x09, 0x32,
+  0x00, 0x5c, 0x0c, 0x64, 0x88, 0x0e, 0x61, 0x02, 0x05, 0x0a, 0x14, 0x26, 0x00, 0x5d, 0x0b, 0x63,
+  0x89, 0x0e, 0x43, 0x82, 0x04, 0x09, 0x42, 0x00, 0x5e, 0x08, 0x23, 0xc9, 0x1e, 0x21, 0x42, 0x04,
+  0x5f, 0x06, 0x14, 0x78, 0x0e, 0x04, 0x60, 0x07, 0x22, 0xc9, 0x0e, 0x41, 0x02, 0x61, 0x09, 0x44,
+  0x88, 0x1e, 0x44, 0x84, 0x84, 0x18, 0x62, 0x0d, 0x64, 0x88, 0x0e, 0x61, 0xc2, 0x8c, 0x08, 0x22,
+  0x84, 0x04, 0x00, 0x63, 0x08, 0x43, 0x89, 0x1e, 0x43, 0xc2, 0x08, 0x64, 0x0c, 0x64, 0x88, 0x3e,
+  0x61, 0x42, 0x10, 0x11, 0x12, 0x62, 0x00, 0x65, 0x0b, 0x44, 0x88, 0x1e, 0x22, 0x42, 0x90, 0x11,
+  0x01, 0x00, 0x66, 0x0e, 0x64, 0x88, 0x2e, 0x41, 0x42, 0x84, 0x08, 0x32, 0x24, 0x4c, 0x10, 0x00,
+  0x67, 0x0d, 0x54, 0x78, 0x1e, 0x22, 0x82, 0x84, 0x18, 0x13, 0x42, 0x04, 0x00, 0x68, 0x0d, 0x64,
+  0x88, 0x0e, 0x61, 0xc2, 0x8c, 0x08, 0x22, 0x44, 0x48, 0x00, 0x69, 0x0b, 0x63, 0x89, 0x1e, 0x81,
+  0x84, 0x04, 0x09, 0x31, 0x00, 0x6a, 0x0d, 0x73, 0x79, 0x2e, 0xa1, 0x82, 0x04, 0x11, 0x11, 0x22,
+  0x04, 0x00, 0x6b, 0x0d, 0x64, 0x88, 0x0e, 0x61, 0xc2, 0x04, 0x21, 0x11, 0x44, 0x48, 0x00, 0x6c,
+  0x0c, 0x63, 0x89, 0x0e, 0x42, 0x82, 0x04, 0x09, 0x12, 0x62, 0x00, 0x6d, 0x0f, 0x45, 0x88, 0x0e,
+  0x22, 0x42, 0x84, 0x08, 0x21, 0x22, 0x84, 0x88, 0x10, 0x01, 0x6e, 0x0b, 0x44, 0x88, 0x0e, 0x23,
+  0x82, 0x08, 0x11, 0x12, 0x00, 0x6f, 0x0c, 0x44, 0x88, 0x1e, 0x22, 0x82, 0x08, 0x09, 0x21, 0x02,
+  0x00, 0x70, 0x0c, 0x54, 0x78, 0x0e, 0x23, 0x82, 0x90, 0x08, 0x13, 0x06, 0x00, 0x71, 0x0b, 0x54,
+  0x78, 0x1e, 0x44, 0x42, 0x8c, 0x09, 0x13, 0x00, 0x72, 0x0c, 0x44, 0x88, 0x0e, 0x21, 0x42, 0x88,
+  0x10, 0x13, 0x06, 0x00, 0x73, 0x08, 0x43, 0x89, 0x1e, 0x64, 0x46, 0x00, 0x74, 0x0e, 0x64, 0x88,
+  0x1e, 0x61, 0x82, 0x0c, 0x09, 0x13, 0x22, 0x48, 0x08, 0x00, 0x75, 0x0b, 0x44, 0x88, 0x0e, 0x41,
+  0x84, 0x08, 0x09, 0x31, 0x00, 0x76, 0x0c, 0x43, 0x89, 0x0e, 0x21, 0x44, 0x88, 0x08, 0x11, 0x02,
+  0x00, 0x77, 0x0f, 0x45, 0x88, 0x0e, 0x61, 0x44, 0x84, 0x10, 0x11, 0x22, 0x44, 0x88, 0x10, 0x00,
+  0x78, 0x0c, 0x44, 0x88, 0x0e, 0x41, 0x42, 0x08, 0x11, 0x11, 0x24, 0x00, 0x79, 0x0d, 0x54, 0x78,
+  0x0e, 0x41, 0x84, 0x84, 0x20, 0x12, 0x42, 0x04, 0x00, 0x7a, 0x09, 0x44, 0x88, 0x0e, 0x44, 0x82,
+  0x04, 0x21, 0x7b, 0x0d, 0x74, 0x88, 0x2e, 0x22, 0x02, 0x85, 0x10, 0x14, 0x24, 0x90, 0x00, 0x7c,
+  0x06, 0x61, 0x8a, 0x0e, 0x06, 0x7d, 0x0e, 0x74, 0x88, 0x0e, 0x82, 0x82, 0x04, 0x12, 0x11, 0x28,
+  0x84, 0x10, 0x00, 0x7e, 0x09, 0x24, 0xc8, 0x1e, 0x21, 0x44, 0x84, 0x00, 0x7f, 0x05, 0x00, 0x88,
+  0x0e, 0x80, 0x05, 0x00, 0x88, 0x0e, 0x81, 0x05, 0x00, 0x88, 0x0e, 0x82, 0x05, 0x00, 0x88, 0x0e,
+  0x83, 0x05, 0x00, 0x88, 0x0e, 0x84, 0x05, 0x00, 0x88, 0x0e, 0x85, 0x05, 0x00, 0x88, 0x0e, 0x86,
+  0x05, 0x00, 0x88, 0x0e, 0x87, 0x05, 0x00, 0x88, 0x0e, 0x88, 0x05, 0x00, 0x88, 0x0e, 0x89, 0x05,
+  0x00, 0x88, 0x0e, 0x8a, 0x05, 0x00, 0x88, 0x0e, 0x8b, 0x05, 0x00, 0x88, 0x0e, 0x8c, 0x05, 0x00,
+  0x88, 0x0e, 0x8d, 0x05, 0x00, 0x88, 0x0e, 0x8e, 0x05, 0x00, 0x88, 0x0e, 0x8f, 0x05, 0x00, 0x88,
+  0x0e, 0x90, 0x05, 0x00, 0x88, 0x0e, 0x91, 0x05, 0x00, 0x88, 0x0e, 0x92, 0x05, 0x00, 0x88, 0x0e,
+  0x93, 0x05, 0x00, 0x88, 0x0e, 0x94, 0x05, 0x00, 0x88, 0x0e, 0x95, 0x05, 0x00, 0x88, 0x0e, 0x96,
+  0x05, 0x00, 0x88, 0x0e, 0x97, 0x05, 0x00, 0x88, 0x0e, 0x98, 0x05, 0x00, 0x88, 0x0e, 0x99, 0x05,
+  0x00, 0x88, 0x0e, 0x9a, 0x05, 0x00, 0x88, 0x0e, 0x9b, 0x05, 0x00, 0x88, 0x0e, 0x9c, 0x05, 0x00,
+  0x88, 0x0e, 0x9d, 0x05, 0x00, 0x88, 0x0e, 0x9e, 0x05, 0x00, 0x88, 0x0e, 0x9f, 0x05, 0x00, 0x88,
+  0x0e, 0xa0, 0x05, 0x00, 0x88, 0x0e, 0xa1, 0x07, 0x61, 0x8a, 0x0e, 0x21, 0x08, 0xa2, 0x0e, 0x64,
+  0x78, 0x2e, 0x41, 0x48, 0x84, 0x08, 0x11, 0x64, 0x48, 0x08, 0x00, 0xa3, 0x0e, 0x64, 0x88, 0x2e,
+  0x41, 0x42, 0x10, 0x09, 0x13, 0x42, 0x44, 0x08, 0x00, 0xa4, 0x0e, 0x55, 0x88, 0x0e, 0x61, 0x42,
+  0x0c, 0x09, 0x11, 0x64, 0x44, 0x98, 0x00, 0xa5, 0x0f, 0x65, 0x88, 0x0e, 0x61, 0x42, 0x84, 0x08,
+  0x51, 0x24, 0x48, 0x91, 0x20, 0x00, 0xa6, 0x07, 0x71, 0x8a, 0x0e, 0x23, 0x06, 0xa7, 0x0d, 0x74,
+  0x88, 0x1e, 0x64, 0x46, 0x04, 0x09, 0x31, 0x86, 0x04, 0x00, 0xa8, 0x07, 0x13, 0xd9, 0x0e, 0x21,
+  0x02, 0xa9, 0x10, 0x65, 0x88, 0x1e, 0x23, 0x42, 0x84, 0x18, 0x32, 0x44, 0x44, 0x88, 0x10, 0x23,
+  0x00, 0xaa, 0x09, 0x53, 0xa9, 0x1e, 0x23, 0x42, 0x88, 0x19, 0xab, 0x0b, 0x34, 0x98, 0x1e, 0x21,
+  0x44, 0x04, 0x09, 0x11, 0x00, 0xac, 0x08, 0x33, 0x89, 0x0e, 0x43, 0x82, 0x04, 0xad, 0x06, 0x13,
+  0xa9, 0x0e, 0x03, 0xae, 0x0e, 0x65, 0x88, 0x1e, 0x23, 0x46, 0x8c, 0x28, 0x31, 0x42, 0xc4, 0x08,
+  0x00, 0xaf, 0x06, 0x13, 0xd9, 0x0e, 0x03, 0xb0, 0x0b, 0x33, 0xb9, 0x1e, 0x21, 0x42, 0x84, 0x08,
+  0x01, 0x00, 0xb1, 0x09, 0x53, 0x89, 0x1e, 0x21, 0x46, 0x04, 0x1a, 0xb2, 0x0c, 0x53, 0xa9, 0x1e,
+  0x21, 0x42, 0x04, 0x09, 0x11, 0x62, 0x00, 0xb3, 0x09, 0x53, 0xa9, 0x0e, 0x62, 0xc6, 0x8c, 0x00,
+  0xb4, 0x07, 0x22, 0xc9, 0x1e, 0x22, 0x00, 0xb5, 0x0c, 0x54, 0x78, 0x0e, 0x41, 0x84, 0x08, 0x21,
+  0x11, 0x06, 0x00, 0xb6, 0x0f, 0x65, 0x88, 0x1e, 0x27, 0x48, 0x84, 0x10, 0x11, 0x24, 0x44, 0x90,
+  0x10, 0x01, 0xb7, 0x06, 0x11, 0xaa, 0x0e, 0x01, 0xb8, 0x07, 0x22, 0x79, 0x1e, 0x22, 0x00, 0xb9,
+  0x0b, 0x53, 0xa9, 0x1e, 0x21, 0x84, 0x04, 0x09, 0x31, 0x00, 0xba, 0x0b, 0x53, 0xa9, 0x1e, 0x21,
+  0x42, 0x84, 0x08, 0x34, 0x00, 0xbb, 0x0c, 0x34, 0x98, 0x0e, 0x21, 0x82, 0x84, 0x10, 0x11, 0x02,
+  0x00, 0xbc, 0x0f, 0x74, 0x88, 0x0e, 0x61, 0xc2, 0x84, 0x09, 0x11, 0x44, 0x04, 0x91, 0x10, 0x00,
+  0xbd, 0x0f, 0x74, 0x88, 0x0e, 0x61, 0xc2, 0x84, 0x08, 0x21, 0x22, 0x4c, 0x90, 0x20, 0x03, 0xbe,
+  0x0f, 0x74, 0x88, 0x0e, 0x81, 0x82, 0x04, 0x12, 0x11, 0x22, 0x04, 0x91, 0x10, 0x00, 0xbf, 0x0d,
+  0x63, 0x89, 0x1e, 0xa1, 0x42, 0x04, 0x09, 0x11, 0x22, 0x04, 0x00, 0xc0, 0x0d, 0x74, 0x88, 0x1e,
+  0x81, 0x82, 0x88, 0x08, 0x62, 0x44, 0x48, 0x00, 0xc1, 0x0d, 0x74, 0x88, 0x2e, 0x41, 0xc2, 0x88,
+  0x08, 0x62, 0x44, 0x48, 0x00, 0xc2, 0x0e, 0x74, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x10, 0x11, 0xc4,
+  0x88, 0x90, 0x00, 0xc3, 0x0e, 0x74, 0x88, 0x1e, 0x21, 0x44, 0x04, 0x11, 0x11, 0xc4, 0x88, 0x90,
+  0x00, 0xc4, 0x0d, 0x74, 0x88, 0x0e, 0x41, 0x42, 0x89, 0x08, 0x62, 0x44, 0x48, 0x00, 0xc5, 0x0e,
+  0x74, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x10, 0x11, 0xc4, 0x88, 0x90, 0x00, 0xc6, 0x0e, 0x64, 0x88,
+  0x1e, 0x24, 0x42, 0x84, 0x08, 0x51, 0x22, 0x44, 0x08, 0x01, 0xc7, 0x0f, 0x74, 0x78, 0x1e, 0x22,
+  0x82, 0x88, 0x09, 0x13, 0x24, 0x84, 0x90, 0x20, 0x00, 0xc8, 0x0c, 0x74, 0x88, 0x1e, 0x81, 0x42,
+  0x94, 0x19, 0x11, 0x86, 0x00, 0xc9, 0x0c, 0x74, 0x88, 0x2e, 0x41, 0x82, 0x94, 0x19, 0x11, 0x86,
+  0x00, 0xca, 0x0c, 0x74, 0x88, 0x1e, 0x22, 0x82, 0x98, 0x19, 0x11, 0x86, 0x00, 0xcb, 0x0c, 0x74,
+  0x88, 0x0e, 0x41, 0x02, 0x95, 0x19, 0x11, 0x86, 0x00, 0xcc, 0x0d, 0x73, 0x89, 0x0e, 0x61, 0x42,
+  0x8c, 0x08, 0x12, 0x24, 0xc4, 0x00, 0xcd, 0x0d, 0x73, 0x89, 0x2e, 0x21, 0x42, 0x8c, 0x08, 0x12,
+  0x24, 0xc4, 0x00, 0xce, 0x0d, 0x73, 0x89, 0x1e, 0x21, 0x42, 0x90, 0x08, 0x12, 0x24, 0xc4, 0x00,
+  0xcf, 0x0d, 0x73, 0x89, 0x0e, 0x21, 0xc2, 0x8c, 0x08, 0x12, 0x24, 0xc4, 0x00, 0xd0, 0x10, 0x65,
+  0x88, 0x1e, 0x43, 0x82, 0x90, 0x08, 0x11, 0x24, 0x44, 0x90, 0x10, 0x23, 0x00, 0xd1, 0x0f, 0x74,
+  0x88, 0x1e, 0x21, 0x44, 0x84, 0x08, 0x32, 0x42, 0xc4, 0x10, 0x21, 0x01, 0xd2, 0x0f, 0x74, 0x88,
+  0x1e, 0x81, 0x82, 0x88, 0x08, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xd3, 0x0f, 0x74, 0x88, 0x2e,
+  0x41, 0xc2, 0x88, 0x08, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xd4, 0x10, 0x74, 0x88, 0x1e, 0x22,
+  0x82, 0x84, 0x10, 0x11, 0x44, 0x88, 0x90, 0x10, 0x22, 0x00, 0xd5, 0x10, 0x74, 0x88, 0x1e, 0x21,
+  0x44, 0x04, 0x11, 0x11, 0x44, 0x88, 0x90, 0x10, 0x22, 0x00, 0xd6, 0x0f, 0x74, 0x88, 0x0e, 0x41,
+  0x42, 0x89, 0x08, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xd7, 0x0b, 0x33, 0x89, 0x0e, 0x21, 0x42,
+  0x84, 0x08, 0x11, 0x00, 0xd8, 0x0c, 0x64, 0x88, 0x1e, 0x24, 0x46, 0x90, 0x18, 0x41, 0x02, 0x00,
+  0xd9, 0x0f, 0x74, 0x88, 0x1e, 0x81, 0x42, 0x04, 0x11, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xda,
+  0x0f, 0x74, 0x88, 0x2e, 0x41, 0x82, 0x04, 0x11, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xdb, 0x0f,
+  0x74, 0x88, 0x1e, 0x22, 0x82, 0x08, 0x11, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xdc, 0x0f, 0x74,
+  0x88, 0x0e, 0x41, 0x02, 0x05, 0x11, 0x22, 0x44, 0x48, 0x08, 0x11, 0x00, 0xdd, 0x10, 0x75, 0x88,
+  0x3e, 0x61, 0x82, 0x84, 0x09, 0x11, 0x22, 0x4c, 0xa0, 0x40, 0x41, 0x00, 0xde, 0x0d, 0x64, 0x88,
+  0x0e, 0x61, 0x46, 0x04, 0x11, 0x42, 0x22, 0x0c, 0x00, 0xdf, 0x10, 0x64, 0x88, 0x1e, 0x22, 0x82,
+  0x88, 0x08, 0x11, 0x22, 0x44, 0x10, 0x11, 0x21, 0x00, 0xe0, 0x0c, 0x74, 0x88, 0x1e, 0x81, 0x82,
+  0x11, 0x11, 0x12, 0x62, 0x00, 0xe1, 0x0c, 0x74, 0x88, 0x2e, 0x41, 0xc2, 0x11, 0x11, 0x12, 0x62,
+  0x00, 0xe2, 0x0d, 0x74, 0x88, 0x2e, 0x41, 0x42, 0x84, 0x22, 0x22, 0x24, 0xc4, 0x00, 0xe3, 0x0d,
+  0x74, 0x88, 0x1e, 0x21, 0x44, 0x04, 0x23, 0x22, 0x24, 0xc4, 0x00, 0xe4, 0x0c, 0x64, 0x88, 0x1e,
+  0x21, 0x42, 0x11, 0x11, 0x12, 0x62, 0x00, 0xe5, 0x0e, 0x74, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x10,
+  0x42, 0x44, 0x48, 0x88, 0x01, 0xe6, 0x0b, 0x45, 0x88, 0x0e, 0x44, 0x44, 0x88, 0x10, 0x42, 0x00,
+  0xe7, 0x0b, 0x53, 0x79, 0x1e, 0x43, 0xc2, 0x88, 0x08, 0x01, 0x00, 0xe8, 0x0d, 0x74, 0x88, 0x1e,
+  0x81, 0x82, 0x89, 0x08, 0x41, 0x46, 0x04, 0x00, 0xe9, 0x0d, 0x74, 0x88, 0x2e, 0x41, 0xc2, 0x89,
+  0x08, 0x41, 0x46, 0x04, 0x00, 0xea, 0x0e, 0x74, 0x88, 0x1e, 0x22, 0x82, 0x84, 0x12, 0x11, 0x82,
+  0x8c, 0x08, 0x00, 0xeb, 0x0d, 0x64, 0x88, 0x1e, 0x21, 0x42, 0x89, 0x08, 0x41, 0x46, 0x04, 0x00,
+  0xec, 0x0c, 0x73, 0x89, 0x0e, 0x61, 0x02, 0x09, 0x09, 0x12, 0x62, 0x00, 0xed, 0x0c, 0x73, 0x89,
+  0x2e, 0x21, 0x02, 0x09, 0x09, 0x12, 0x62, 0x00, 0xee, 0x0d, 0x73, 0x89, 0x1e, 0x21, 0x42, 0x84,
+  0x11, 0x12, 0x24, 0xc4, 0x00, 0xef, 0x0c, 0x63, 0x89, 0x0e, 0x21, 0xc2, 0x08, 0x09, 0x12, 0x62,
+  0x00, 0xf0, 0x10, 0x74, 0x88, 0x0e, 0x21, 0x82, 0x04, 0x09, 0x11, 0x28, 0x04, 0x91, 0x10, 0x22,
+  0x00, 0xf1, 0x0e, 0x74, 0x88, 0x1e, 0x21, 0x44, 0x84, 0x1a, 0x11, 0x44, 0x88, 0x90, 0x00, 0xf2,
+  0x0e, 0x74, 0x88, 0x1e, 0x81, 0x82, 0x89, 0x08, 0x22, 0x24, 0x84, 0x08, 0x00, 0xf3, 0x0e, 0x74,
+  0x88, 0x2e, 0x41, 0xc2, 0x89, 0x08, 0x22, 0x24, 0x84, 0x08, 0x00, 0xf4, 0x0f, 0x74, 0x88, 0x1e,
+  0x22, 0x82, 0x84, 0x12, 0x11, 0x44, 0x48, 0x08, 0x11, 0x00, 0xf5, 0x0f, 0x74, 0x88, 0x1e, 0x21,
+  0x44, 0x04, 0x13, 0x11, 0x44, 0x48, 0x08, 0x11, 0x00, 0xf6, 0x0e, 0x64, 0x88, 0x0e, 0x41, 0x42,
+  0x89, 0x08, 0x22, 0x24, 0x84, 0x08, 0x00, 0xf7, 0x09, 0x53, 0x89, 0x1e, 0x81, 0x06, 0x85, 0x00,
+  0xf8, 0x09, 0x44, 0x88, 0x1e, 0x24, 0x48, 0x90, 0x00, 0xf9, 0x0d, 0x74, 0x88, 0x1e, 0x81, 0x42,
+  0x05, 0x11, 0x22, 0x24, 0xc4, 0x00, 0xfa, 0x0d, 0x74, 0x88, 0x2e, 0x41, 0x82, 0x05, 0x11, 0x22,
+  0x24, 0xc4, 0x00, 0xfb, 0x0e, 0x74, 0x88, 0x1e, 0x22, 0x82, 0x04, 0x0a, 0x22, 0x44, 0x48, 0x88,
+  0x01, 0xfc, 0x0d, 0x64, 0x88, 0x0e, 0x41, 0x02, 0x05, 0x11, 0x22, 0x24, 0xc4, 0x00, 0xfd, 0x0f,
+  0x84, 0x78, 0x2e, 0x41, 0x82, 0x05, 0x11, 0x12, 0x82, 0x48, 0x08, 0x11, 0x00, 0xfe, 0x0e, 0x74,
+  0x78, 0x0e, 0x61, 0xc2, 0x8c, 0x08, 0x42, 0x22, 0x4c, 0x18, 0x00, 0xff, 0x0f, 0x74, 0x78, 0x0e,
+  0x41, 0x02, 0x05, 0x11, 0x12, 0x82, 0x48, 0x08, 0x11, 0x00, 0x00, 0x00, 0x00, 0x04, 0xff, 0xff,
+  0x00, 0x00,
+};
+
+#endif
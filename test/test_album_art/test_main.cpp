@@ -0,0 +1,132 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "album_art.h"
+
+static AlbumArtDecoder decoder;
+static uint8_t xbm[ALBUM_ART_BYTES];
+
+struct Source
+{
+  std::vector<uint8_t> data;
+  size_t position;
+};
+
+static size_t read_source(void *ctx, uint8_t *buf, size_t len)
+{
+  Source *source = (Source *)ctx;
+  size_t count = source->data.size() - source->position;
+  if (count > len) count = len;
+  memcpy(buf, source->data.data() + source->position, count);
+  source->position += count;
+  return count;
+}
+
+static Source load(const char *name)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/album_art/%s", TEST_DATA_DIR, name);
+  Source source = {{}, 0};
+  FILE *file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+  int c;
+  while ((c = fgetc(file)) != EOF) source.data.push_back((uint8_t)c);
+  fclose(file);
+  return source;
+}
+
+static bool decode(const char *name)
+{
+  Source source = load(name);
+  memset(xbm, 0xA5, sizeof(xbm));
+  return decoder.decode(read_source, &source, xbm);
+}
+
+// Share of set (bright) pixels in the thumbnail rectangle [x0, x1) x [y0, y1)
+static float coverage(int x0, int y0, int x1, int y1)
+{
+  int set = 0;
+  for (int y = y0; y < y1; y++)
+  {
+    for (int x = x0; x < x1; x++)
+    {
+      if (xbm[y * ((ALBUM_ART_SIZE + 7) / 8) + x / 8] & (1 << (x % 8))) set++;
+    }
+  }
+  return (float)set / ((x1 - x0) * (y1 - y0));
+}
+
+// The thumbnail of an image with a dark left and a bright right half
+static void assert_vertical_split()
+{
+  TEST_ASSERT_TRUE(coverage(2, 2, 20, 46) < 0.05f);
+  TEST_ASSERT_TRUE(coverage(28, 2, 46, 46) > 0.95f);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_baseline_444()
+{
+  TEST_ASSERT_TRUE(decode("baseline_444.jpg"));
+  assert_vertical_split();
+}
+
+void test_subsampled_420()
+{
+  TEST_ASSERT_TRUE(decode("subsampled_420.jpg"));
+  TEST_ASSERT_TRUE(coverage(2, 2, 46, 20) > 0.95f);
+  TEST_ASSERT_TRUE(coverage(2, 28, 46, 46) < 0.05f);
+}
+
+void test_grayscale_gradient()
+{
+  TEST_ASSERT_TRUE(decode("grayscale.jpg"));
+  // The dithered density follows the gradient from left to right
+  float left = coverage(0, 0, 12, 48);
+  float middle = coverage(18, 0, 30, 48);
+  float right = coverage(36, 0, 48, 48);
+  TEST_ASSERT_TRUE(left < 0.25f);
+  TEST_ASSERT_TRUE(middle > 0.3f && middle < 0.7f);
+  TEST_ASSERT_TRUE(right > 0.75f);
+}
+
+void test_restart_markers()
+{
+  TEST_ASSERT_TRUE(decode("restart.jpg"));
+  assert_vertical_split();
+}
+
+void test_large_image_dc_only()
+{
+  TEST_ASSERT_TRUE(decode("large_dc.jpg"));
+  TEST_ASSERT_TRUE(coverage(2, 2, 22, 22) > 0.95f);
+  TEST_ASSERT_TRUE(coverage(26, 2, 46, 22) < 0.05f);
+  TEST_ASSERT_TRUE(coverage(2, 26, 46, 46) < 0.05f);
+}
+
+void test_progressive_rejected()
+{
+  TEST_ASSERT_FALSE(decode("progressive.jpg"));
+}
+
+void test_truncated_rejected()
+{
+  Source source = load("baseline_444.jpg");
+  source.data.resize(source.data.size() / 2);
+  TEST_ASSERT_FALSE(decoder.decode(read_source, &source, xbm));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_baseline_444);
+  RUN_TEST(test_subsampled_420);
+  RUN_TEST(test_grayscale_gradient);
+  RUN_TEST(test_restart_markers);
+  RUN_TEST(test_large_image_dc_only);
+  RUN_TEST(test_progressive_rejected);
+  RUN_TEST(test_truncated_rejected);
+  return UNITY_END();
+}
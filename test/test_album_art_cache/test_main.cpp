@@ -0,0 +1,146 @@
+#include <unity.h>
+#include <LittleFS.h>
+#include "album_art_cache.h"
+#include "checksum.h"
+
+// Two cover urls with the same 32 bit FNV-1a hash
+static const char *URL = "https://i.scdn.co/image/00062938";
+static const char *COLLIDING_URL = "https://i.scdn.co/image/000298eb";
+
+static AlbumArtCache cache;
+
+static void make_thumbnail(uint8_t *xbm, uint8_t seed)
+{
+  for (size_t i = 0; i < ALBUM_ART_BYTES; i++)
+    xbm[i] = (uint8_t)(seed + i * 7);
+}
+
+static void make_url(char *url, size_t size, int index)
+{
+  snprintf(url, size, "https://i.scdn.co/image/cover%d", index);
+}
+
+void setUp()
+{
+  mock::fs_reset();
+  cache.begin();
+}
+
+void tearDown() {}
+
+void test_stored_thumbnail_is_found()
+{
+  uint8_t xbm[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 1);
+  TEST_ASSERT_FALSE(cache.get(URL, loaded));
+  TEST_ASSERT_TRUE(cache.put(URL, xbm));
+  TEST_ASSERT_TRUE(cache.get(URL, loaded));
+  TEST_ASSERT_EQUAL_MEMORY(xbm, loaded, ALBUM_ART_BYTES);
+}
+
+void test_colliding_url_is_a_miss()
+{
+  TEST_ASSERT_EQUAL(fnv1a(URL, strlen(URL)), fnv1a(COLLIDING_URL, strlen(COLLIDING_URL)));
+  uint8_t xbm[ALBUM_ART_BYTES], other[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 1);
+  make_thumbnail(other, 2);
+  TEST_ASSERT_TRUE(cache.put(URL, xbm));
+  TEST_ASSERT_FALSE(cache.get(COLLIDING_URL, loaded));
+
+  // The colliding cover replaces the slot
+  TEST_ASSERT_TRUE(cache.put(COLLIDING_URL, other));
+  TEST_ASSERT_TRUE(cache.get(COLLIDING_URL, loaded));
+  TEST_ASSERT_EQUAL_MEMORY(other, loaded, ALBUM_ART_BYTES);
+  TEST_ASSERT_FALSE(cache.get(URL, loaded));
+}
+
+void test_too_long_url_is_not_cached()
+{
+  char url[ALBUM_ART_CACHE_ID_SIZE + 8];
+  memset(url, 'a', sizeof(url) - 1);
+  url[sizeof(url) - 1] = '\0';
+  uint8_t xbm[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 1);
+  TEST_ASSERT_FALSE(cache.put(url, xbm));
+  TEST_ASSERT_FALSE(cache.get(url, xbm));
+}
+
+void test_index_survives_a_restart()
+{
+  uint8_t xbm[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 3);
+  TEST_ASSERT_TRUE(cache.put(URL, xbm));
+
+  AlbumArtCache restarted;
+  restarted.begin();
+  TEST_ASSERT_TRUE(restarted.get(URL, loaded));
+  TEST_ASSERT_EQUAL_MEMORY(xbm, loaded, ALBUM_ART_BYTES);
+}
+
+void test_damaged_slot_is_a_miss()
+{
+  uint8_t xbm[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 4);
+  TEST_ASSERT_TRUE(cache.put(URL, xbm));
+
+  File data = LittleFS.open(ALBUM_ART_CACHE_DATA, "r+");
+  data.seek(ALBUM_ART_CACHE_ID_SIZE + 10, SeekSet);
+  data.write((uint8_t)~xbm[10]);
+  data.close();
+  TEST_ASSERT_FALSE(cache.get(URL, loaded));
+}
+
+void test_interrupted_index_write_keeps_old_index()
+{
+  uint8_t xbm[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  make_thumbnail(xbm, 5);
+  TEST_ASSERT_TRUE(cache.put(URL, xbm));
+
+  // The power fails while the second cover is written
+  mock::fs_write_budget = ALBUM_ART_CACHE_SLOT_BYTES + 100;
+  make_thumbnail(xbm, 6);
+  TEST_ASSERT_FALSE(cache.put("https://i.scdn.co/image/second", xbm));
+  mock::fs_write_budget = -1;
+
+  AlbumArtCache restarted;
+  restarted.begin();
+  TEST_ASSERT_TRUE(restarted.get(URL, loaded));
+  TEST_ASSERT_FALSE(restarted.get("https://i.scdn.co/image/second", loaded));
+}
+
+void test_least_recently_used_is_evicted()
+{
+  uint8_t xbm[ALBUM_ART_BYTES], loaded[ALBUM_ART_BYTES];
+  char url[64];
+  for (int i = 0; i < ALBUM_ART_CACHE_SLOTS; i++)
+  {
+    make_url(url, sizeof(url), i);
+    make_thumbnail(xbm, i);
+    TEST_ASSERT_TRUE(cache.put(url, xbm));
+  }
+  // The first cover is used again, so the second one is the oldest
+  make_url(url, sizeof(url), 0);
+  TEST_ASSERT_TRUE(cache.get(url, loaded));
+  make_url(url, sizeof(url), ALBUM_ART_CACHE_SLOTS);
+  TEST_ASSERT_TRUE(cache.put(url, xbm));
+
+  make_url(url, sizeof(url), 0);
+  TEST_ASSERT_TRUE(cache.get(url, loaded));
+  make_url(url, sizeof(url), 1);
+  TEST_ASSERT_FALSE(cache.get(url, loaded));
+  make_url(url, sizeof(url), 2);
+  TEST_ASSERT_TRUE(cache.get(url, loaded));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_stored_thumbnail_is_found);
+  RUN_TEST(test_colliding_url_is_a_miss);
+  RUN_TEST(test_too_long_url_is_not_cached);
+  RUN_TEST(test_index_survives_a_restart);
+  RUN_TEST(test_damaged_slot_is_a_miss);
+  RUN_TEST(test_interrupted_index_write_keeps_old_index);
+  RUN_TEST(test_least_recently_used_is_evicted);
+  return UNITY_END();
+}
@@ -0,0 +1,166 @@
+#include <unity.h>
+#include <stdio.h>
+#include <new>
+#include <string>
+#include <U8g2lib.h>
+#include "gzip_stream.h"
+#include "response_parser.h"
+#include "frame_store.h"
+#include "view_test_font.h"
+#include "display_view.h"
+
+/*
+  Allocations of the steady state poll cycle on the device side of the HTTP client: inflate,
+  parse, build the view and render it through the page buffer into a FrameStore. Only C++
+  allocations are counted: operator new is replaced, malloc(), realloc() and strdup() called
+  directly are not seen (the modules under test do not call them today). The first cycle may
+  allocate (the inflate window is kept for the next body), every later one must not allocate at
+  all. HTTPClient and the TLS client are not part of the host build, their allocations are only
+  counted on the device by ParseMetrics.
+*/
+
+static uint32_t allocations;
+
+void *operator new(size_t size)
+{
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  allocations++;
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+// Page buffer SH1106 without a bus
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_128x64_noname_1(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+static TestDisplay display;
+static GzipStream gzip_body;
+static ResponseParser parser;
+static FrameStore frame;
+static uint8_t cover[ALBUM_ART_BYTES];
+static MemoryStream *connection;
+
+static bool gzip_connected()
+{
+  return gzip_body.is_inflating();
+}
+
+static bool http_connected()
+{
+  return connection->available() > 0;
+}
+
+static std::string load(const char *name)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/responses/%s", TEST_DATA_DIR, name);
+  FILE *file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+  std::string data;
+  int c;
+  while ((c = fgetc(file)) != EOF)
+    data += (char)c;
+  fclose(file);
+  return data;
+}
+
+// One poll like get_player_state(): parse the body, build the view and render it
+static void poll(const std::string &body, bool gzip, PlayerState &state)
+{
+  MemoryStream stream(body.data(), body.size());
+  connection = &stream;
+  state = PlayerState();
+  if (gzip)
+  {
+    gzip_body.begin(&stream);
+    parser.begin(gzip_body, (int)body.size(), gzip_connected);
+  }
+  else
+    parser.begin(stream, (int)body.size(), http_connected);
+  parser.parse_player(state);
+  gzip_body.end();
+
+  DisplayView view = DisplayBuilder()
+                         .build_track(state.track)
+                         .build_album(state.album)
+                         .build_artist(state.artist)
+                         .build_album_art(cover)
+                         .build_play_stop_view(state.playing)
+                         .get_view();
+  view.draw_music_view(display, &frame);
+}
+
+// Allocations of every cycle after the first one
+static void check_cycles(const char *name, bool gzip)
+{
+  std::string body = load(name);
+  PlayerState state;
+  allocations = 0;
+  poll(body, gzip, state);
+  uint32_t first = allocations;
+  TEST_ASSERT_TRUE(state.has_item);
+  TEST_ASSERT_FALSE(gzip_body.has_error());
+
+  allocations = 0;
+  for (int cycle = 0; cycle < 10; cycle++)
+    poll(body, gzip, state);
+  printf("%-26s first cycle %lu allocations, then %lu in 10 cycles\n", name, (unsigned long)first,
+         (unsigned long)allocations);
+  TEST_ASSERT_EQUAL(0, allocations);
+  TEST_ASSERT_EQUAL_STRING("Paranoid Android", state.track);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_identity_cycle_does_not_allocate()
+{
+  check_cycles("player_track.json", false);
+}
+
+void test_gzip_cycle_does_not_allocate()
+{
+  check_cycles("player_track.json.gz", true);
+}
+
+void test_queue_parse_does_not_allocate()
+{
+  std::string body = load("queue_empty.json");
+  PlayerState state;
+  allocations = 0;
+  for (int cycle = 0; cycle < 10; cycle++)
+  {
+    MemoryStream stream(body.data(), body.size());
+    connection = &stream;
+    parser.begin(stream, (int)body.size(), http_connected);
+    parser.parse_queue(state);
+  }
+  TEST_ASSERT_EQUAL(0, allocations);
+}
+
+int main()
+{
+  display.begin();
+  UNITY_BEGIN();
+  RUN_TEST(test_identity_cycle_does_not_allocate);
+  RUN_TEST(test_gzip_cycle_does_not_allocate);
+  RUN_TEST(test_queue_parse_does_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,94 @@
+#include <unity.h>
+#include <LittleFS.h>
+#include "atomic_record.h"
+
+#define PATH "/record"
+#define MAGIC 0x54535431 // "TST1"
+
+static const char OLD_PAYLOAD[] = "old payload";
+static const char NEW_PAYLOAD[] = "new and somewhat longer payload";
+
+void setUp()
+{
+  mock::fs_reset();
+}
+
+void tearDown() {}
+
+void test_written_payload_is_read_back()
+{
+  AtomicRecord record(PATH, MAGIC);
+  char payload[64];
+  TEST_ASSERT_EQUAL(0, record.read(payload, sizeof(payload)));
+  TEST_ASSERT_TRUE(record.write(OLD_PAYLOAD, sizeof(OLD_PAYLOAD)));
+  TEST_ASSERT_EQUAL(sizeof(OLD_PAYLOAD), record.read(payload, sizeof(payload)));
+  TEST_ASSERT_EQUAL_STRING(OLD_PAYLOAD, payload);
+  TEST_ASSERT_FALSE(LittleFS.exists(PATH ".tmp"));
+}
+
+void test_other_magic_is_not_read()
+{
+  TEST_ASSERT_TRUE(AtomicRecord(PATH, MAGIC).write(OLD_PAYLOAD, sizeof(OLD_PAYLOAD)));
+  char payload[64];
+  TEST_ASSERT_EQUAL(0, AtomicRecord(PATH, MAGIC + 1).read(payload, sizeof(payload)));
+}
+
+void test_payload_larger_than_capacity_is_not_read()
+{
+  AtomicRecord record(PATH, MAGIC);
+  TEST_ASSERT_TRUE(record.write(NEW_PAYLOAD, sizeof(NEW_PAYLOAD)));
+  char payload[sizeof(NEW_PAYLOAD) - 1];
+  TEST_ASSERT_EQUAL(0, record.read(payload, sizeof(payload)));
+}
+
+void test_damaged_payload_is_not_read()
+{
+  AtomicRecord record(PATH, MAGIC);
+  TEST_ASSERT_TRUE(record.write(OLD_PAYLOAD, sizeof(OLD_PAYLOAD)));
+  File file = LittleFS.open(PATH, "r+");
+  file.seek(8, SeekSet);
+  file.write((uint8_t)'X');
+  file.close();
+  char payload[64];
+  TEST_ASSERT_EQUAL(0, record.read(payload, sizeof(payload)));
+}
+
+// A power loss after any number of written bytes leaves the old record
+void test_interrupted_write_keeps_old_record()
+{
+  const long record_bytes = 4 + 2 + sizeof(NEW_PAYLOAD) + 4;
+  for (long budget = 0; budget < record_bytes; budget++)
+  {
+    mock::fs_reset();
+    AtomicRecord record(PATH, MAGIC);
+    TEST_ASSERT_TRUE(record.write(OLD_PAYLOAD, sizeof(OLD_PAYLOAD)));
+    mock::fs_write_budget = budget;
+    TEST_ASSERT_FALSE(record.write(NEW_PAYLOAD, sizeof(NEW_PAYLOAD)));
+    mock::fs_write_budget = -1;
+
+    char payload[64];
+    TEST_ASSERT_EQUAL(sizeof(OLD_PAYLOAD), record.read(payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_STRING(OLD_PAYLOAD, payload);
+  }
+}
+
+void test_removed_record_is_gone()
+{
+  AtomicRecord record(PATH, MAGIC);
+  TEST_ASSERT_TRUE(record.write(OLD_PAYLOAD, sizeof(OLD_PAYLOAD)));
+  TEST_ASSERT_TRUE(record.remove());
+  char payload[64];
+  TEST_ASSERT_EQUAL(0, record.read(payload, sizeof(payload)));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_written_payload_is_read_back);
+  RUN_TEST(test_other_magic_is_not_read);
+  RUN_TEST(test_payload_larger_than_capacity_is_not_read);
+  RUN_TEST(test_damaged_payload_is_not_read);
+  RUN_TEST(test_interrupted_write_keeps_old_record);
+  RUN_TEST(test_removed_record_is_gone);
+  return UNITY_END();
+}
@@ -0,0 +1,202 @@
+#include <unity.h>
+#include "button_input.h"
+
+#define PLAIN_PIN 12
+#define LONG_PIN 14
+#define DOUBLE_PIN 13
+
+static const uint8_t PINS[BUTTON_COUNT] = {PLAIN_PIN, LONG_PIN};
+static const uint8_t GESTURES[BUTTON_COUNT] = {0, BUTTON_GESTURE_LONG};
+
+static ButtonInput buttons;
+
+// Moves the clock forward and collects the events of every poll on the way, 1 ms apart
+static int wait_ms(uint32_t ms, ButtonEvent *events, int max_events)
+{
+  int count = 0;
+  ButtonEvent event;
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    mock::advance_us(1000);
+    while (buttons.poll(event))
+    {
+      TEST_ASSERT_LESS_THAN(max_events, count);
+      events[count++] = event;
+    }
+  }
+  return count;
+}
+
+// Presses a pin with a few bounces on both edges and releases it after held_ms
+static void press(uint8_t pin, uint32_t held_ms)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    mock::set_pin(pin, HIGH);
+    mock::advance_us(300);
+    mock::set_pin(pin, LOW);
+    mock::advance_us(300);
+  }
+  mock::set_pin(pin, HIGH);
+  mock::advance_us(held_ms * 1000);
+  mock::set_pin(pin, LOW);
+  mock::advance_us(300);
+  mock::set_pin(pin, HIGH);
+  mock::advance_us(300);
+  mock::set_pin(pin, LOW);
+}
+
+static void begin(const uint8_t (&pins)[BUTTON_COUNT], const uint8_t (&gestures)[BUTTON_COUNT])
+{
+  memset(mock::pin_level, 0, sizeof(mock::pin_level));
+  memset(mock::pin_isr, 0, sizeof(mock::pin_isr));
+  mock::set_ms(1000);
+  buttons.begin(pins, gestures);
+}
+
+void setUp()
+{
+  begin(PINS, GESTURES);
+}
+
+void tearDown() {}
+
+void test_plain_button_reports_press_before_release()
+{
+  ButtonEvent events[4];
+  mock::set_pin(PLAIN_PIN, HIGH);
+  uint32_t pressed_at = micros();
+  int count = wait_ms(BUTTON_DEBOUNCE_MS + 1, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(0, events[0].button);
+  TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+  TEST_ASSERT_EQUAL(pressed_at, events[0].timestamp);
+
+  // Holding it does not add a long press
+  count = wait_ms(BUTTON_LONG_PRESS_MS * 2, events, 4);
+  mock::set_pin(PLAIN_PIN, LOW);
+  count += wait_ms(BUTTON_DOUBLE_PRESS_MS * 2, events, 4);
+  TEST_ASSERT_EQUAL(0, count);
+  TEST_ASSERT_FALSE(buttons.is_busy());
+}
+
+void test_short_press_is_reported_on_release()
+{
+  ButtonEvent events[4];
+  mock::set_pin(LONG_PIN, HIGH);
+  TEST_ASSERT_EQUAL(0, wait_ms(100, events, 4));
+  mock::set_pin(LONG_PIN, LOW);
+  uint32_t released_at = micros();
+  int count = wait_ms(BUTTON_LONG_PRESS_MS, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(1, events[0].button);
+  TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+  TEST_ASSERT_EQUAL(released_at, events[0].timestamp);
+}
+
+// The long press replaces the press, a skip button must not send next and previous
+void test_long_press_is_the_only_event()
+{
+  ButtonEvent events[4];
+  press(LONG_PIN, BUTTON_LONG_PRESS_MS + 200);
+  int count = wait_ms(BUTTON_LONG_PRESS_MS, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_LONG_PRESS, events[0].type);
+}
+
+void test_long_press_is_reported_while_held()
+{
+  ButtonEvent events[4];
+  mock::set_pin(LONG_PIN, HIGH);
+  uint32_t pressed_at = micros();
+  int count = wait_ms(BUTTON_LONG_PRESS_MS + 10, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_LONG_PRESS, events[0].type);
+  TEST_ASSERT_EQUAL(pressed_at + BUTTON_LONG_PRESS_MS * 1000UL, events[0].timestamp);
+  mock::set_pin(LONG_PIN, LOW);
+  TEST_ASSERT_EQUAL(0, wait_ms(BUTTON_LONG_PRESS_MS, events, 4));
+}
+
+// Edges which are polled late, e.g. after a blocking request, yield the same single event
+void test_late_poll_replays_long_press()
+{
+  ButtonEvent events[4];
+  press(LONG_PIN, BUTTON_LONG_PRESS_MS + 50);
+  mock::advance_us(2000000);
+  int count = wait_ms(1, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_LONG_PRESS, events[0].type);
+
+  press(LONG_PIN, 80);
+  mock::advance_us(2000000);
+  count = wait_ms(1, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+}
+
+void test_double_press_replaces_both_presses()
+{
+  const uint8_t pins[BUTTON_COUNT] = {PLAIN_PIN, DOUBLE_PIN};
+  const uint8_t gestures[BUTTON_COUNT] = {0, BUTTON_GESTURE_DOUBLE | BUTTON_GESTURE_LONG};
+  begin(pins, gestures);
+  ButtonEvent events[4];
+  press(DOUBLE_PIN, 80);
+  int count = wait_ms(100, events, 4);
+  TEST_ASSERT_EQUAL(0, count);
+  TEST_ASSERT_TRUE(buttons.is_busy());
+  press(DOUBLE_PIN, 80);
+  count = wait_ms(BUTTON_DOUBLE_PRESS_MS * 3, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_DOUBLE_PRESS, events[0].type);
+  TEST_ASSERT_FALSE(buttons.is_busy());
+}
+
+void test_single_press_waits_for_double_press_window()
+{
+  const uint8_t pins[BUTTON_COUNT] = {PLAIN_PIN, DOUBLE_PIN};
+  const uint8_t gestures[BUTTON_COUNT] = {0, BUTTON_GESTURE_DOUBLE};
+  begin(pins, gestures);
+  ButtonEvent events[4];
+  uint32_t pressed_at = micros();
+  press(DOUBLE_PIN, 80);
+  int count = wait_ms(BUTTON_DOUBLE_PRESS_MS - 200, events, 4);
+  TEST_ASSERT_EQUAL(0, count);
+  count = wait_ms(BUTTON_DOUBLE_PRESS_MS, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+  // The press started with the first bounce
+  TEST_ASSERT_EQUAL(pressed_at + 1800 + BUTTON_DOUBLE_PRESS_MS * 1000UL, events[0].timestamp);
+
+  // A second press after the window is a press of its own
+  press(DOUBLE_PIN, 80);
+  count = wait_ms(BUTTON_DOUBLE_PRESS_MS * 2, events, 4);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+}
+
+void test_bounces_shorter_than_debounce_are_ignored()
+{
+  ButtonEvent events[4];
+  for (int i = 0; i < 10; i++)
+  {
+    mock::set_pin(PLAIN_PIN, HIGH);
+    mock::advance_us((BUTTON_DEBOUNCE_MS - 5) * 1000);
+    mock::set_pin(PLAIN_PIN, LOW);
+    mock::advance_us(1000);
+  }
+  TEST_ASSERT_EQUAL(0, wait_ms(BUTTON_DEBOUNCE_MS * 2, events, 4));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_plain_button_reports_press_before_release);
+  RUN_TEST(test_short_press_is_reported_on_release);
+  RUN_TEST(test_long_press_is_the_only_event);
+  RUN_TEST(test_long_press_is_reported_while_held);
+  RUN_TEST(test_late_poll_replays_long_press);
+  RUN_TEST(test_double_press_replaces_both_presses);
+  RUN_TEST(test_single_press_waits_for_double_press_window);
+  RUN_TEST(test_bounces_shorter_than_debounce_are_ignored);
+  return UNITY_END();
+}
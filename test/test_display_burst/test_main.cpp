@@ -0,0 +1,106 @@
+#include <unity.h>
+#include <U8g2lib.h>
+#include "view_test_font.h"
+#include "display_view.h"
+
+/*
+  Frame time of draw_music_view() over the bit banged I2C bus with the 24 byte bursts of the
+  Wire buffer (before) and with whole pages per transfer (after). The pins cost nothing on the
+  host, every I2C delay busy waits the 2 us of u8x8_gpio_and_delay_arduino() at 400 kHz, which
+  is what dominates the frame time on the device.
+*/
+
+#define FRAMES 5
+#define I2C_DELAY_US 2
+
+static bool limit_burst;
+static uint32_t delays;
+
+static uint8_t byte_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  // The default burst of the CAD procedure stays when the message is not answered
+  if (msg == U8X8_MSG_BYTE_GET_MAX_BURST && limit_burst)
+    return 0;
+  return u8x8_byte_sw_i2c(u8x8, msg, arg_int, arg_ptr);
+}
+
+static uint8_t gpio_and_delay_cb(u8x8_t *, uint8_t msg, uint8_t, void *)
+{
+  if (msg == U8X8_MSG_DELAY_I2C)
+  {
+    delays++;
+    uint64_t start = mock::host_us();
+    while (mock::host_us() - start < I2C_DELAY_US)
+      ;
+  }
+  return 1;
+}
+
+class BenchDisplay : public U8G2
+{
+public:
+  BenchDisplay()
+  {
+    u8g2_Setup_sh1106_i2c_128x64_noname_1(&u8g2, U8G2_R0, byte_cb, gpio_and_delay_cb);
+  }
+};
+
+static BenchDisplay display;
+static uint8_t cover[ALBUM_ART_BYTES];
+
+// Shortest of FRAMES full frames, every page is sent
+static uint32_t measure_frame_time(bool limited, uint32_t &frame_delays)
+{
+  limit_burst = limited;
+  DisplayView view = DisplayBuilder()
+                         .build_track("Paranoid Android")
+                         .build_album("OK Computer")
+                         .build_artist("Radiohead")
+                         .build_album_art(cover)
+                         .build_play_stop_view(true)
+                         .get_view();
+  uint32_t best = UINT32_MAX;
+  for (int i = 0; i < FRAMES; i++)
+  {
+    display.invalidatePageHash();
+    delays = 0;
+    uint32_t start = micros();
+    view.draw_music_view(display);
+    uint32_t frame_time_us = micros() - start;
+    if (frame_time_us < best)
+      best = frame_time_us;
+    frame_delays = delays;
+  }
+  return best;
+}
+
+void setUp()
+{
+  mock::real_time = true;
+  for (size_t i = 0; i < sizeof(cover); i++)
+    cover[i] = (uint8_t)(i * 37);
+  display.begin();
+}
+
+void tearDown()
+{
+  mock::real_time = false;
+}
+
+void test_whole_page_bursts_shorten_the_frame()
+{
+  uint32_t delays_before, delays_after;
+  uint32_t before = measure_frame_time(true, delays_before);
+  uint32_t after = measure_frame_time(false, delays_after);
+  printf("frame_time_us with 24 byte bursts: %lu (%lu I2C delays)\n", (unsigned long)before, (unsigned long)delays_before);
+  printf("frame_time_us with whole pages: %lu (%lu I2C delays)\n", (unsigned long)after, (unsigned long)delays_after);
+  // The times are only reported, the number of bus delays is what the burst size changes
+  TEST_ASSERT_LESS_THAN(delays_before, delays_after);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_whole_page_bursts_shorten_the_frame);
+  return UNITY_END();
+}
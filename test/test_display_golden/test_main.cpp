@@ -0,0 +1,191 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <U8g2lib.h>
+#include "view_test_font.h"
+#include "display_view.h"
+
+/*
+  Golden images of the screens. Every case is drawn through the page buffer like on the device,
+  the tiles which reach the display are captured and written as PBM with the u8x8 capture
+  helpers, the output must match test/data/golden/<case>.pbm byte for byte. The render time of
+  every case is printed, the best of RENDER_RUNS runs.
+
+  Run with UPDATE_GOLDENS=1 in the environment to write the goldens after an intended change.
+*/
+
+#define RENDER_RUNS 5
+#define CAPTURE_TILE_WIDTH 16
+#define CAPTURE_TILE_HEIGHT 8
+
+// Page buffer SH1106 without a bus, the display procedure is wrapped to capture the tiles
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_128x64_noname_1(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+static TestDisplay display;
+static u8x8_msg_cb display_cb;
+static uint8_t capture[CAPTURE_TILE_WIDTH * CAPTURE_TILE_HEIGHT * 8];
+static uint8_t cover[ALBUM_ART_BYTES];
+static std::string pbm;
+
+// Same as u8x8_d_capture(), which the bundled u8g2 does not build
+static uint8_t capture_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  if (msg == U8X8_MSG_DISPLAY_DRAW_TILE)
+  {
+    u8x8_tile_t *tile = (u8x8_tile_t *)arg_ptr;
+    memcpy(&capture[(tile->y_pos * CAPTURE_TILE_WIDTH + tile->x_pos) * 8], tile->tile_ptr, tile->cnt * 8);
+  }
+  return display_cb(u8x8, msg, arg_int, arg_ptr);
+}
+
+static void append_pbm(const char *s)
+{
+  pbm += s;
+}
+
+static void begin_capture()
+{
+  memset(capture, 0, sizeof(capture));
+  // Unchanged pages would not be sent again
+  display.invalidatePageHash();
+}
+
+static void check_golden(const char *name, uint32_t render_us)
+{
+  pbm.clear();
+  u8x8_capture_write_pbm_pre(CAPTURE_TILE_WIDTH, CAPTURE_TILE_HEIGHT, append_pbm);
+  u8x8_capture_write_pbm_buffer(capture, CAPTURE_TILE_WIDTH, CAPTURE_TILE_HEIGHT, u8x8_capture_get_pixel_1, append_pbm);
+  printf("%s: render_us %lu\n", name, (unsigned long)render_us);
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s/golden/%s.pbm", TEST_DATA_DIR, name);
+  if (getenv("UPDATE_GOLDENS"))
+  {
+    FILE *file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+    fwrite(pbm.data(), 1, pbm.size(), file);
+    fclose(file);
+    return;
+  }
+
+  FILE *file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+  std::string golden;
+  int c;
+  while ((c = fgetc(file)) != EOF)
+    golden += (char)c;
+  fclose(file);
+  TEST_ASSERT_TRUE_MESSAGE(golden == pbm, path);
+}
+
+static void check_music_view(const char *name, const char *track, const char *album, const char *artist,
+                             const uint8_t *albumArt, bool playing)
+{
+  DisplayView view = DisplayBuilder()
+                         .build_track(track)
+                         .build_album(album)
+                         .build_artist(artist)
+                         .build_album_art(albumArt)
+                         .build_play_stop_view(playing)
+                         .get_view();
+  uint32_t best = UINT32_MAX;
+  for (int i = 0; i < RENDER_RUNS; i++)
+  {
+    begin_capture();
+    uint32_t start = micros();
+    view.draw_music_view(display);
+    uint32_t render_us = micros() - start;
+    if (render_us < best)
+      best = render_us;
+  }
+  check_golden(name, best);
+}
+
+static void check_message(const char *name, const char *text, int x, int y)
+{
+  uint32_t best = UINT32_MAX;
+  for (int i = 0; i < RENDER_RUNS; i++)
+  {
+    begin_capture();
+    uint32_t start = micros();
+    DisplayView::draw_message(display, text, x, y);
+    uint32_t render_us = micros() - start;
+    if (render_us < best)
+      best = render_us;
+  }
+  check_golden(name, best);
+}
+
+void setUp()
+{
+  mock::real_time = true;
+}
+
+void tearDown()
+{
+  mock::real_time = false;
+}
+
+void test_playing()
+{
+  check_music_view("playing", "Paranoid Android", "OK Computer", "Radiohead", cover, true);
+}
+
+void test_paused()
+{
+  check_music_view("paused", "Paranoid Android", "OK Computer", "Radiohead", cover, false);
+}
+
+void test_long_title()
+{
+  check_music_view("long_title", "Bohemian Rhapsody - Remastered 2011 Version", "A Night at the Opera (2011 Remaster)",
+                   "Queen", cover, true);
+}
+
+void test_utf8()
+{
+  check_music_view("utf8", "Svefn-g-englar", "\xC3\x81g\xC3\xA6tis byrjun", "Sigur R\xC3\xB3s", cover, true);
+}
+
+void test_no_cover()
+{
+  check_music_view("no_cover", "Paranoid Android", "OK Computer", "Radiohead", nullptr, true);
+}
+
+void test_error_message()
+{
+  check_message("error_message", "Couldn't refresh access token", 64, 32);
+}
+
+void test_skipping_message()
+{
+  check_message("skipping_message", "Skipping...", 31, 32);
+}
+
+int main()
+{
+  // A diagonal checker pattern as cover, so its position and orientation show in the golden
+  for (size_t i = 0; i < sizeof(cover); i++)
+    cover[i] = (i / ((ALBUM_ART_SIZE + 7) / 8)) % 8 < 4 ? 0x0F : 0xF0;
+  display_cb = display.getU8x8()->display_cb;
+  display.getU8x8()->display_cb = capture_cb;
+  display.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_playing);
+  RUN_TEST(test_paused);
+  RUN_TEST(test_long_title);
+  RUN_TEST(test_utf8);
+  RUN_TEST(test_no_cover);
+  RUN_TEST(test_error_message);
+  RUN_TEST(test_skipping_message);
+  return UNITY_END();
+}
@@ -0,0 +1,170 @@
+#include <unity.h>
+#include <stdio.h>
+#include <U8g2lib.h>
+#include "display_transmitter.h"
+#include "virtual_sh1106.h"
+
+/*
+  The background transmitter against a pin model: the GPIO enable register drives the open
+  drain SCL/SDA lines of an SH1106 model, the test plays timer1 by firing its interrupt.
+*/
+
+#define SCL_PIN 5
+#define SDA_PIN 4
+
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_i2c_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_sw_i2c, u8x8_dummy_cb);
+    u8x8_SetPin_SW_I2C(getU8x8(), SCL_PIN, SDA_PIN, U8X8_PIN_NONE);
+  }
+};
+
+static TestDisplay display;
+static DisplayTransmitter transmitter;
+static VirtualSH1106 panel;
+static uint8_t scl_level = 1;
+static uint32_t scl_edges;
+
+// An enabled output pulls its line low, a released line is high
+static void on_gpio(uint32_t enable)
+{
+  uint8_t scl = enable & (1UL << SCL_PIN) ? 0 : 1;
+  uint8_t sda = enable & (1UL << SDA_PIN) ? 0 : 1;
+  if (scl != scl_level)
+    scl_edges++;
+  scl_level = scl;
+  panel.on_lines(scl, sda);
+}
+
+// Runs the interrupt until the queue is empty, returns the number of ticks
+static uint32_t drain()
+{
+  uint32_t ticks = 0;
+  while (mock::fire_timer1())
+    ticks++;
+  return ticks;
+}
+
+static void draw_pattern(uint8_t seed)
+{
+  uint8_t *buffer = display.getBufferPtr();
+  for (uint16_t i = 0; i < SH1106_WIDTH * SH1106_HEIGHT / 8; i++)
+    buffer[i] = (uint8_t)(i * 13 + seed);
+  display.sendBuffer();
+}
+
+static void check_panel_shows_buffer()
+{
+  uint8_t glass[SH1106_WIDTH * SH1106_HEIGHT / 8];
+  panel.get_frame(glass);
+  TEST_ASSERT_EQUAL_MEMORY(display.getBufferPtr(), glass, sizeof(glass));
+}
+
+void setUp()
+{
+  mock::on_yield = nullptr;
+}
+
+void tearDown() {}
+
+void test_send_buffer_only_enqueues()
+{
+  draw_pattern(1);
+  TEST_ASSERT_FALSE(transmitter.is_idle());
+  TEST_ASSERT_TRUE(transmitter.get_transfers_queued() > transmitter.get_transfers_sent());
+
+  drain();
+  TEST_ASSERT_TRUE(transmitter.is_idle());
+  TEST_ASSERT_EQUAL(transmitter.get_transfers_queued(), transmitter.get_transfers_sent());
+  check_panel_shows_buffer();
+}
+
+void test_every_tick_moves_one_burst_of_edges()
+{
+  panel.reset_counters();
+  draw_pattern(2);
+  uint32_t ticks = 0;
+  uint32_t isr_us = transmitter.get_isr_us();
+  for (;;)
+  {
+    uint32_t edges = scl_edges;
+    if (!mock::fire_timer1())
+      break;
+    ticks++;
+    TEST_ASSERT_TRUE(scl_edges - edges <= DISPLAY_TX_EDGES_PER_TICK);
+  }
+  check_panel_shows_buffer();
+  // Two edges per bit and four for every start and stop condition, bursts run across entries
+  uint32_t edges = 2 * panel.get_bus_cycles() + 4 * panel.get_transfers();
+  TEST_ASSERT_EQUAL((edges + DISPLAY_TX_EDGES_PER_TICK - 1) / DISPLAY_TX_EDGES_PER_TICK, ticks);
+  // The bursts wait out the gaps between their edges
+  uint32_t gaps_us = (edges - ticks) * DISPLAY_TX_EDGE_GAP_NS / 1000;
+  TEST_ASSERT_GREATER_OR_EQUAL(gaps_us, transmitter.get_isr_us() - isr_us);
+  printf("Frame: %lu edges in %lu ticks, %lu us in the interrupt\n", (unsigned long)edges, (unsigned long)ticks,
+         (unsigned long)(transmitter.get_isr_us() - isr_us));
+}
+
+// The mark is sent with the last transfer queued before it, later ones do not move it
+void test_mark_reports_when_its_transfers_are_sent()
+{
+  transmitter.mark();
+  TEST_ASSERT_TRUE(transmitter.is_mark_sent());
+  TEST_ASSERT_EQUAL(micros(), transmitter.get_marked_at());
+
+  draw_pattern(6);
+  transmitter.mark();
+  uint32_t marked_transfers = transmitter.get_transfers_queued();
+  display.setContrast(7);
+  while (transmitter.get_transfers_sent() < marked_transfers)
+  {
+    TEST_ASSERT_FALSE(transmitter.is_mark_sent());
+    mock::advance_us(DISPLAY_TX_TICK_PERIOD_US);
+    mock::fire_timer1();
+  }
+  TEST_ASSERT_TRUE(transmitter.is_mark_sent());
+  uint32_t marked_at = micros();
+  TEST_ASSERT_EQUAL(marked_at, transmitter.get_marked_at());
+  TEST_ASSERT_FALSE(transmitter.is_idle());
+
+  mock::advance_us(DISPLAY_TX_TICK_PERIOD_US);
+  drain();
+  TEST_ASSERT_EQUAL(marked_at, transmitter.get_marked_at());
+}
+
+void test_full_queue_waits_for_the_interrupt()
+{
+  // Three frames do not fit into the queue, the producer yields until the interrupt made space
+  mock::on_yield = []()
+  {
+    for (int i = 0; i < 64; i++)
+      mock::fire_timer1();
+  };
+  uint32_t stalls = transmitter.get_stalls();
+  draw_pattern(3);
+  draw_pattern(4);
+  draw_pattern(5);
+  TEST_ASSERT_TRUE(transmitter.get_stalls() > stalls);
+
+  transmitter.flush();
+  TEST_ASSERT_TRUE(transmitter.is_idle());
+  check_panel_shows_buffer();
+}
+
+int main()
+{
+  mock::on_gpio = on_gpio;
+  transmitter.begin(display);
+  display.begin();
+  drain();
+  panel.reset_counters();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_send_buffer_only_enqueues);
+  RUN_TEST(test_every_tick_moves_one_burst_of_edges);
+  RUN_TEST(test_mark_reports_when_its_transfers_are_sent);
+  RUN_TEST(test_full_queue_waits_for_the_interrupt);
+  return UNITY_END();
+}
@@ -0,0 +1,113 @@
+#include <unity.h>
+#include <U8g2lib.h>
+#include "view_test_font.h"
+#include "display_view.h"
+
+// Full buffer SH1106 without a bus, the frame is read back from the buffer
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+static TestDisplay display;
+static uint8_t cover[ALBUM_ART_BYTES];
+
+static const char *LONG_TITLE = "A very long track title which never fits";
+
+static bool pixel(int x, int y)
+{
+  return display.getBufferPtr()[(y / 8) * 128 + x] & (1 << (y % 8));
+}
+
+// Number of set pixels in the rectangle [x0, x1) x [y0, y1)
+static int count_pixels(int x0, int y0, int x1, int y1)
+{
+  int count = 0;
+  for (int y = y0; y < y1; y++)
+  {
+    for (int x = x0; x < x1; x++)
+    {
+      if (pixel(x, y))
+        count++;
+    }
+  }
+  return count;
+}
+
+static void draw(const char *track, const uint8_t *albumArt, bool albumArtSpace)
+{
+  DisplayView view = DisplayBuilder()
+                         .build_track(track)
+                         .build_album("Album")
+                         .build_artist("Artist")
+                         .build_album_art(albumArt)
+                         .build_album_art_space(albumArtSpace)
+                         .build_play_stop_view(true)
+                         .get_view();
+  view.draw_music_view(display);
+}
+
+void setUp()
+{
+  display.begin();
+  // An empty cover, everything right of the text column belongs to it
+  memset(cover, 0, sizeof(cover));
+}
+
+void tearDown() {}
+
+void test_long_title_without_cover_uses_full_width()
+{
+  draw(LONG_TITLE, nullptr, false);
+  TEST_ASSERT_GREATER_THAN(0, count_pixels(110, 0, 128, 11));
+}
+
+void test_long_title_ends_left_of_cover()
+{
+  draw(LONG_TITLE, cover, false);
+  int right = 128 - ALBUM_ART_SIZE - 2;
+  TEST_ASSERT_EQUAL(0, count_pixels(right, 0, 128, 40));
+  // The title is cut to the longest prefix which fits with the dots instead of being clipped
+  char expected[64] = "";
+  for (size_t cut = 1; cut < strlen(LONG_TITLE); cut++)
+  {
+    char candidate[64];
+    snprintf(candidate, sizeof(candidate), "%.*s...", (int)cut, LONG_TITLE);
+    if (display.getUTF8Width(candidate) > right - 10)
+      break;
+    strcpy(expected, candidate);
+  }
+  uint8_t frame[1024];
+  memcpy(frame, display.getBufferPtr(), sizeof(frame));
+  draw(expected, cover, false);
+  TEST_ASSERT_EQUAL_MEMORY(frame, display.getBufferPtr(), sizeof(frame));
+}
+
+void test_pending_cover_keeps_its_space()
+{
+  draw(LONG_TITLE, nullptr, true);
+  TEST_ASSERT_EQUAL(0, count_pixels(128 - ALBUM_ART_SIZE - 2, 0, 128, 40));
+}
+
+void test_cut_keeps_utf8_characters()
+{
+  // Two byte characters, every possible cut would split one if it counted bytes
+  draw("\xc3\xa4\xc3\xb6\xc3\xbc\xc3\xa4\xc3\xb6\xc3\xbc\xc3\xa4\xc3\xb6\xc3\xbc\xc3\xa4\xc3\xb6\xc3\xbc\xc3\xa4\xc3\xb6",
+       cover, false);
+  TEST_ASSERT_EQUAL(0, count_pixels(128 - ALBUM_ART_SIZE - 2, 0, 128, 40));
+  TEST_ASSERT_GREATER_THAN(0, count_pixels(10, 0, 20, 11));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_long_title_without_cover_uses_full_width);
+  RUN_TEST(test_long_title_ends_left_of_cover);
+  RUN_TEST(test_pending_cover_keeps_its_space);
+  RUN_TEST(test_cut_keeps_utf8_characters);
+  return UNITY_END();
+}
@@ -0,0 +1,137 @@
+#include <unity.h>
+#include <U8g2lib.h>
+#include "frame_store.h"
+#include "virtual_sh1106.h"
+
+/*
+  The track transition against the SH1106 model. After every bus transfer the lines which the
+  start line wrapped to the bottom of the glass must already hold the new frame.
+*/
+
+#define SLIDE_STEP 4
+
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_i2c_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_sw_i2c, u8x8_dummy_cb);
+  }
+};
+
+static TestDisplay display;
+static VirtualSH1106 panel;
+static uint8_t old_frame[FRAME_BYTES];
+static uint8_t new_frame[FRAME_BYTES];
+static uint32_t stale_transfers;
+static uint32_t checked_transfers;
+
+static uint8_t frame_pixel(const uint8_t *frame, uint16_t x, uint16_t y)
+{
+  return (frame[(y / 8) * SH1106_WIDTH + x] >> (y % 8)) & 1;
+}
+
+// Glass rows below 64 - start line show RAM lines 0..start line - 1, these must be new
+static void check_wrapped_lines()
+{
+  uint8_t start_line = panel.get_start_line();
+  checked_transfers++;
+  for (uint16_t y = SH1106_HEIGHT - start_line; y < SH1106_HEIGHT; y++)
+    for (uint16_t x = 0; x < SH1106_WIDTH; x++)
+      if (panel.get_pixel(x, y) != frame_pixel(new_frame, x, y + start_line - SH1106_HEIGHT))
+      {
+        stale_transfers++;
+        return;
+      }
+}
+
+static uint8_t checking_byte_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  uint8_t result = u8x8_byte_sw_i2c(u8x8, msg, arg_int, arg_ptr);
+  if (msg == U8X8_MSG_BYTE_END_TRANSFER)
+    check_wrapped_lines();
+  return result;
+}
+
+static void fill_pattern(uint8_t *frame, uint8_t seed)
+{
+  for (uint16_t i = 0; i < FRAME_BYTES; i++)
+    frame[i] = (uint8_t)(i * 31 + seed);
+}
+
+static void show_old_frame(FrameStore &store)
+{
+  panel.attach(display.getU8x8());
+  display.begin();
+  display.setStartLine(0);
+  fill_pattern(old_frame, 7);
+  fill_pattern(new_frame, 101);
+  store.set_frame(old_frame);
+  store.restore(display);
+  display.getU8x8()->byte_cb = checking_byte_cb;
+  stale_transfers = 0;
+  checked_transfers = 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_every_step_writes_the_lines_before_it_shows_them()
+{
+  FrameStore store;
+  show_old_frame(store);
+
+  store.begin_slide(display, new_frame, SLIDE_STEP);
+  uint8_t steps = 1;
+  while (store.slide_step(display))
+    steps++;
+
+  TEST_ASSERT_EQUAL(SH1106_HEIGHT / SLIDE_STEP, steps);
+  TEST_ASSERT_TRUE(checked_transfers > 0);
+  TEST_ASSERT_EQUAL(0, stale_transfers);
+  TEST_ASSERT_FALSE(store.is_sliding());
+}
+
+void test_slide_ends_with_the_new_frame_on_the_glass()
+{
+  FrameStore store;
+  show_old_frame(store);
+
+  store.begin_slide(display, new_frame, SLIDE_STEP);
+  TEST_ASSERT_TRUE(store.is_sliding());
+  store.finish_slide(display);
+
+  uint8_t glass[FRAME_BYTES];
+  panel.get_frame(glass);
+  TEST_ASSERT_EQUAL(0, panel.get_start_line());
+  TEST_ASSERT_EQUAL_MEMORY(new_frame, glass, FRAME_BYTES);
+  TEST_ASSERT_EQUAL_MEMORY(new_frame, store.get_frame(), FRAME_BYTES);
+}
+
+void test_a_new_slide_finishes_the_running_one()
+{
+  FrameStore store;
+  show_old_frame(store);
+  uint8_t third_frame[FRAME_BYTES];
+  fill_pattern(third_frame, 55);
+
+  store.begin_slide(display, new_frame, SLIDE_STEP);
+  store.slide_step(display);
+  store.slide_step(display);
+  store.begin_slide(display, third_frame, SLIDE_STEP);
+
+  // The first slide is complete before the second one starts from start line 0
+  TEST_ASSERT_EQUAL(0, panel.get_start_line());
+  TEST_ASSERT_EQUAL_MEMORY(new_frame, store.get_frame(), FRAME_BYTES);
+  store.finish_slide(display);
+  TEST_ASSERT_EQUAL_MEMORY(third_frame, store.get_frame(), FRAME_BYTES);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_every_step_writes_the_lines_before_it_shows_them);
+  RUN_TEST(test_slide_ends_with_the_new_frame_on_the_glass);
+  RUN_TEST(test_a_new_slide_finishes_the_running_one);
+  return UNITY_END();
+}
@@ -0,0 +1,252 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include "gzip_stream.h"
+#include "response_parser.h"
+
+/*
+  Gzip content negotiation against a mock server. The server answers from the payloads of
+  test/data/responses, gzip encoded if the request accepts it. The connection delivers TCP
+  segments at LINK_BYTES_PER_S on the mock clock, the inflate and parse time is measured on the
+  host clock. Per payload the bytes received and the wall time (air time plus host time) of both
+  encodings are reported, the parsed values of both must be the same. Payloads with a back
+  reference beyond GZIP_WINDOW_SIZE cost a failed gzip request and an identity one.
+*/
+
+#define SEGMENT_SIZE 1460
+// Throughput of a TLS connection on the ESP8266
+#define LINK_BYTES_PER_S 40000
+
+struct Response
+{
+  std::string body;
+  bool gzip;
+};
+
+class MockServer
+{
+private:
+  static bool load(const std::string &name, std::string &data)
+  {
+    std::string path = std::string(TEST_DATA_DIR) + "/responses/" + name;
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+      return false;
+    data.clear();
+    int c;
+    while ((c = fgetc(file)) != EOF)
+      data += (char)c;
+    fclose(file);
+    return true;
+  }
+
+public:
+  uint32_t requests = 0;
+
+  Response get(const char *name, bool accept_gzip)
+  {
+    Response response;
+    requests++;
+    response.gzip = accept_gzip && load(std::string(name) + ".gz", response.body);
+    if (!response.gzip)
+      TEST_ASSERT_TRUE_MESSAGE(load(name, response.body), name);
+    return response;
+  }
+};
+
+// Connection which delivers the body in segments, each one takes its air time on the mock clock
+class Connection : public Stream
+{
+private:
+  const std::string &_data;
+  size_t _pos = 0;
+  size_t _segment_end = 0;
+
+  void next_segment()
+  {
+    size_t end = std::min(_data.size(), _pos + SEGMENT_SIZE);
+    mock::advance_us((uint32_t)((uint64_t)(end - _segment_end) * 1000000 / LINK_BYTES_PER_S));
+    _segment_end = end;
+  }
+
+public:
+  explicit Connection(const std::string &data) : _data(data) {}
+  bool connected() { return _pos < _data.size(); }
+  size_t received() { return _segment_end; }
+
+  int available() override
+  {
+    if (_pos == _segment_end && _pos < _data.size())
+      next_segment();
+    return (int)(_segment_end - _pos);
+  }
+  int read() override { return available() ? (uint8_t)_data[_pos++] : -1; }
+  int peek() override { return available() ? (uint8_t)_data[_pos] : -1; }
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+};
+
+static MockServer server;
+static GzipStream gzip_body;
+static ResponseParser parser;
+static Connection *connection;
+
+static bool http_connected()
+{
+  return connection->connected();
+}
+
+static bool gzip_connected()
+{
+  return gzip_body.is_inflating();
+}
+
+struct Fetch
+{
+  PlayerState state;
+  bool has_item;
+  size_t received;
+  uint32_t air_us;
+  uint32_t host_us;
+  bool inflated;
+};
+
+// One request like get_player_state() and prefetch_next_track(): a failed inflate turns gzip off
+// for the endpoint
+static Fetch fetch(const char *name, bool queue, bool &gzip_enabled)
+{
+  Fetch fetch;
+  Response response = server.get(name, gzip_enabled);
+  Connection body(response.body);
+  connection = &body;
+  uint32_t air_start = micros();
+  uint64_t host_start = mock::host_us();
+
+  if (response.gzip)
+  {
+    gzip_body.begin(&body);
+    parser.begin(gzip_body, (int)response.body.size(), gzip_connected);
+  }
+  else
+    parser.begin(body, (int)response.body.size(), http_connected);
+  fetch.has_item = queue ? parser.parse_queue(fetch.state) : parser.parse_player(fetch.state);
+  fetch.inflated = !response.gzip || !gzip_body.has_error();
+  gzip_body.end();
+  if (!fetch.inflated)
+    gzip_enabled = false;
+
+  fetch.host_us = (uint32_t)(mock::host_us() - host_start);
+  fetch.air_us = micros() - air_start;
+  fetch.received = body.received();
+  return fetch;
+}
+
+// A body which could not be inflated is fetched again right away, the cost of both requests counts
+static Fetch poll(const char *name, bool queue, bool &gzip_enabled)
+{
+  Fetch first = fetch(name, queue, gzip_enabled);
+  if (first.inflated)
+    return first;
+  Fetch retry = fetch(name, queue, gzip_enabled);
+  retry.received += first.received;
+  retry.air_us += first.air_us;
+  retry.host_us += first.host_us;
+  return retry;
+}
+
+// Polls the payload with and without gzip, true if the gzip poll had to fall back to identity
+static bool compare(const char *name, bool queue = false)
+{
+  bool gzip_enabled = false;
+  Fetch identity = poll(name, queue, gzip_enabled);
+  gzip_enabled = true;
+  Fetch gzip = poll(name, queue, gzip_enabled);
+
+  for (const Fetch *fetch : {&identity, &gzip})
+    printf("%-26s %-8s %6lu bytes received, %6lu us wall time (%lu us on air)\n", name,
+           fetch == &identity ? "identity" : gzip_enabled ? "gzip" : "fallback", (unsigned long)fetch->received,
+           (unsigned long)(fetch->air_us + fetch->host_us), (unsigned long)fetch->air_us);
+
+  TEST_ASSERT_TRUE(gzip.inflated);
+  TEST_ASSERT_EQUAL(identity.has_item, gzip.has_item);
+  TEST_ASSERT_EQUAL_STRING(identity.state.track, gzip.state.track);
+  TEST_ASSERT_EQUAL_STRING(identity.state.album, gzip.state.album);
+  TEST_ASSERT_EQUAL_STRING(identity.state.artist, gzip.state.artist);
+  TEST_ASSERT_EQUAL_STRING(identity.state.art_url, gzip.state.art_url);
+  TEST_ASSERT_EQUAL_STRING(identity.state.device, gzip.state.device);
+  TEST_ASSERT_EQUAL(identity.state.playing, gzip.state.playing);
+  if (gzip_enabled)
+    TEST_ASSERT_LESS_THAN(identity.received, gzip.received);
+  return !gzip_enabled;
+}
+
+// The reads of the inflater never wait on the host, the mock clock only moves with the link
+static void advance_on_yield()
+{
+  mock::advance_us(1000);
+}
+
+void setUp()
+{
+  mock::on_yield = advance_on_yield;
+}
+
+void tearDown()
+{
+  mock::on_yield = nullptr;
+}
+
+void test_track()
+{
+  TEST_ASSERT_FALSE(compare("player_track.json"));
+}
+
+void test_markets()
+{
+  TEST_ASSERT_FALSE(compare("player_markets.json"));
+}
+
+// The track markets repeat the album markets more than 8 KB back
+void test_many_artists_falls_back_to_identity()
+{
+  TEST_ASSERT_TRUE(compare("player_many_artists.json"));
+}
+
+void test_podcast()
+{
+  TEST_ASSERT_FALSE(compare("player_podcast.json"));
+}
+
+void test_queue_falls_back_to_identity()
+{
+  TEST_ASSERT_TRUE(compare("queue.json", true));
+}
+
+void test_far_reference_falls_back_to_identity()
+{
+  bool gzip_enabled = true;
+  uint32_t requests = server.requests;
+  Fetch gzip = fetch("player_far_reference.json", false, gzip_enabled);
+  TEST_ASSERT_FALSE(gzip.inflated);
+  TEST_ASSERT_FALSE(gzip_enabled);
+
+  // The retry asks for the identity encoding and gets the whole state
+  Fetch identity = fetch("player_far_reference.json", false, gzip_enabled);
+  TEST_ASSERT_TRUE(identity.inflated);
+  TEST_ASSERT_EQUAL(requests + 2, server.requests);
+  TEST_ASSERT_EQUAL_STRING("Paranoid Android", identity.state.track);
+  TEST_ASSERT_EQUAL_STRING("OK Computer", identity.state.album);
+  TEST_ASSERT_TRUE(identity.state.playing);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_track);
+  RUN_TEST(test_markets);
+  RUN_TEST(test_many_artists_falls_back_to_identity);
+  RUN_TEST(test_podcast);
+  RUN_TEST(test_queue_falls_back_to_identity);
+  RUN_TEST(test_far_reference_falls_back_to_identity);
+  return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include <unity.h>
+#include "request_policy.h"
+
+static RequestPolicy *policy;
+
+void setUp()
+{
+  mock::set_ms(1000000);
+  policy = new RequestPolicy("test");
+}
+
+void tearDown()
+{
+  delete policy;
+}
+
+void test_success_does_not_wait()
+{
+  TEST_ASSERT_TRUE(policy->allow());
+  policy->record(200, 0);
+  TEST_ASSERT_EQUAL(0, policy->get_remaining_wait());
+  TEST_ASSERT_TRUE(policy->allow());
+}
+
+void test_client_errors_are_left_to_the_caller()
+{
+  for (int status : {400, 401, 403, 404})
+  {
+    policy->record(status, 0);
+    TEST_ASSERT_EQUAL(0, policy->get_remaining_wait());
+  }
+}
+
+// A refresh answered with 401 or 403, or with a 200 which could not be read, calls fail()
+void test_failed_calls_back_off_with_jitter()
+{
+  for (int failure = 1; failure < REQUEST_POLICY_BREAKER_THRESHOLD; failure++)
+  {
+    TEST_ASSERT_TRUE(policy->allow());
+    policy->fail();
+    unsigned long backoff = (unsigned long)REQUEST_POLICY_BASE_BACKOFF << (failure - 1);
+    unsigned long wait = policy->get_remaining_wait();
+    TEST_ASSERT_GREATER_OR_EQUAL(backoff / 2, wait);
+    TEST_ASSERT_LESS_OR_EQUAL(backoff, wait);
+
+    TEST_ASSERT_FALSE(policy->allow());
+    mock::set_ms(millis() + wait);
+  }
+  TEST_ASSERT_FALSE(policy->is_open());
+}
+
+void test_breaker_opens_and_probes()
+{
+  for (int failure = 0; failure < REQUEST_POLICY_BREAKER_THRESHOLD; failure++)
+  {
+    mock::set_ms(millis() + policy->get_remaining_wait());
+    TEST_ASSERT_TRUE(policy->allow());
+    policy->fail();
+  }
+  TEST_ASSERT_TRUE(policy->is_open());
+  TEST_ASSERT_EQUAL(REQUEST_POLICY_BREAKER_COOLDOWN, policy->get_remaining_wait());
+
+  // The probe after the cooldown fails, the circuit opens again
+  mock::set_ms(millis() + REQUEST_POLICY_BREAKER_COOLDOWN);
+  TEST_ASSERT_TRUE(policy->allow());
+  policy->record(503, 0);
+  TEST_ASSERT_EQUAL(REQUEST_POLICY_BREAKER_COOLDOWN, policy->get_remaining_wait());
+
+  // The next probe succeeds and closes it
+  mock::set_ms(millis() + REQUEST_POLICY_BREAKER_COOLDOWN);
+  TEST_ASSERT_TRUE(policy->allow());
+  policy->record(200, 0);
+  TEST_ASSERT_FALSE(policy->is_open());
+  TEST_ASSERT_TRUE(policy->allow());
+}
+
+// While the probe is in flight the other callers wait, a lost probe is replaced after the cooldown
+void test_half_open_lets_one_probe_through()
+{
+  for (int failure = 0; failure < REQUEST_POLICY_BREAKER_THRESHOLD; failure++)
+  {
+    mock::set_ms(millis() + policy->get_remaining_wait());
+    TEST_ASSERT_TRUE(policy->allow());
+    policy->fail();
+  }
+  mock::set_ms(millis() + REQUEST_POLICY_BREAKER_COOLDOWN);
+  TEST_ASSERT_TRUE(policy->allow());
+  TEST_ASSERT_FALSE(policy->allow());
+  mock::set_ms(millis() + REQUEST_POLICY_BREAKER_COOLDOWN - 1);
+  TEST_ASSERT_FALSE(policy->allow());
+
+  mock::set_ms(millis() + 1);
+  TEST_ASSERT_TRUE(policy->allow());
+  policy->record(200, 0);
+  TEST_ASSERT_TRUE(policy->allow());
+  TEST_ASSERT_TRUE(policy->allow());
+}
+
+void test_retry_after_is_honored()
+{
+  policy->record(429, 30);
+  TEST_ASSERT_EQUAL(30000, policy->get_remaining_wait());
+  mock::set_ms(millis() + 29999);
+  TEST_ASSERT_FALSE(policy->allow());
+  mock::set_ms(millis() + 1);
+  TEST_ASSERT_TRUE(policy->allow());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_success_does_not_wait);
+  RUN_TEST(test_client_errors_are_left_to_the_caller);
+  RUN_TEST(test_failed_calls_back_off_with_jitter);
+  RUN_TEST(test_breaker_opens_and_probes);
+  RUN_TEST(test_half_open_lets_one_probe_through);
+  RUN_TEST(test_retry_after_is_honored);
+  return UNITY_END();
+}
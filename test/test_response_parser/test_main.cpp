@@ -0,0 +1,259 @@
+#include <unity.h>
+#include <stdio.h>
+#include <new>
+#include <string>
+#include "response_parser.h"
+
+/*
+  Recorded payload benchmark of the response parsers. Every payload of test/data/responses is
+  fed in TCP segments like WiFiClient::available() hands them out, with an empty available()
+  while the next segment is on its way. Per payload and segment size the bytes the parser read
+  are reported as bytes/s over BENCH_RUNS runs, together with the heap allocations and the peak
+  heap of one parse, counted by replacing operator new. The parsed values are checked, the times
+  are only reported.
+
+  Regenerate the payloads with test/data/responses/make_responses.py.
+*/
+
+#define BENCH_RUNS 200
+
+static uint32_t allocations;
+static size_t heap_in_use;
+static size_t heap_peak;
+
+void *operator new(size_t size)
+{
+  // The size is kept in front of the block, so operator delete can account for it
+  size_t *block = (size_t *)malloc(size + sizeof(max_align_t));
+  if (!block)
+    throw std::bad_alloc();
+  *block = size;
+  allocations++;
+  heap_in_use += size;
+  if (heap_in_use > heap_peak)
+    heap_peak = heap_in_use;
+  return (char *)block + sizeof(max_align_t);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (!ptr)
+    return;
+  size_t *block = (size_t *)((char *)ptr - sizeof(max_align_t));
+  heap_in_use -= *block;
+  free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+// Body on a connection which delivers segment bytes at a time
+class SegmentStream : public Stream
+{
+private:
+  const std::string &_data;
+  size_t _segment;
+  size_t _pos = 0;
+  size_t _segment_end = 0;
+  bool _waited = false;
+
+  void next_segment()
+  {
+    _segment_end = std::min(_data.size(), _pos + _segment);
+    _waited = false;
+  }
+
+public:
+  SegmentStream(const std::string &data, size_t segment) : _data(data), _segment(segment) {}
+  bool connected() { return _pos < _data.size(); }
+  size_t position() { return _pos; }
+
+  int available() override
+  {
+    if (_pos == _segment_end && _pos < _data.size())
+    {
+      // The first poll after a segment finds the next one still in flight
+      if (!_waited)
+      {
+        _waited = true;
+        return 0;
+      }
+      next_segment();
+    }
+    return (int)(_segment_end - _pos);
+  }
+  int read() override
+  {
+    if (_pos == _segment_end && _pos < _data.size())
+      next_segment();
+    return _pos < _segment_end ? (uint8_t)_data[_pos++] : -1;
+  }
+  int peek() override { return _pos < _segment_end ? (uint8_t)_data[_pos] : -1; }
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+};
+
+static SegmentStream *connection;
+
+static bool is_connected()
+{
+  return connection->connected();
+}
+
+static std::string load(const char *name)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/responses/%s", TEST_DATA_DIR, name);
+  FILE *file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+  std::string data;
+  int c;
+  while ((c = fgetc(file)) != EOF)
+    data += (char)c;
+  fclose(file);
+  return data;
+}
+
+enum Endpoint
+{
+  USER,
+  PLAYER,
+  QUEUE
+};
+
+struct Result
+{
+  PlayerState state;
+  char user[TRACK_TEXT_SIZE];
+  bool has_item;
+  size_t bytes_read;
+};
+
+static void parse(Endpoint endpoint, const std::string &data, size_t segment, Result &result)
+{
+  static ResponseParser parser;
+  SegmentStream body(data, segment);
+  connection = &body;
+  result.state = PlayerState();
+  result.user[0] = '\0';
+  result.has_item = false;
+  parser.begin(body, (int)data.size(), is_connected);
+  if (endpoint == USER)
+    parser.parse_user(result.user, sizeof(result.user));
+  else if (endpoint == PLAYER)
+    result.has_item = parser.parse_player(result.state);
+  else
+    result.has_item = parser.parse_queue(result.state);
+  result.bytes_read = body.position();
+}
+
+// Parses the payload with every segment size, prints the numbers and returns the last result
+static void bench(const char *name, Endpoint endpoint, Result &result)
+{
+  static const size_t SEGMENTS[] = {64, 536, 1460};
+  std::string data = load(name);
+  mock::real_time = true;
+  for (size_t segment : SEGMENTS)
+  {
+    allocations = 0;
+    heap_peak = heap_in_use;
+    size_t heap_before = heap_in_use;
+    parse(endpoint, data, segment, result);
+    uint32_t parse_allocations = allocations;
+    size_t parse_peak = heap_peak - heap_before;
+
+    uint64_t start = mock::host_us();
+    for (int run = 0; run < BENCH_RUNS; run++)
+      parse(endpoint, data, segment, result);
+    uint64_t time_us = mock::host_us() - start;
+    printf("%-26s %6lu of %6lu bytes, segment %4lu: %10lu B/s, %lu allocations, peak heap %lu bytes\n", name,
+           (unsigned long)result.bytes_read, (unsigned long)data.size(), (unsigned long)segment,
+           (unsigned long)((uint64_t)result.bytes_read * BENCH_RUNS * 1000000 / (time_us ? time_us : 1)),
+           (unsigned long)parse_allocations, (unsigned long)parse_peak);
+  }
+  mock::real_time = false;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_user()
+{
+  Result result;
+  bench("me.json", USER, result);
+  TEST_ASSERT_EQUAL_STRING("Jane Doe", result.user);
+}
+
+void test_player_track()
+{
+  Result result;
+  bench("player_track.json", PLAYER, result);
+  TEST_ASSERT_TRUE(result.has_item);
+  TEST_ASSERT_EQUAL_STRING("Paranoid Android", result.state.track);
+  TEST_ASSERT_EQUAL_STRING("OK Computer", result.state.album);
+  TEST_ASSERT_EQUAL_STRING("Radiohead", result.state.artist);
+  TEST_ASSERT_EQUAL_STRING("https://i.scdn.co/image/ab67616d000000010064", result.state.art_url);
+  TEST_ASSERT_EQUAL_STRING("Living Room", result.state.device);
+  TEST_ASSERT_EQUAL_STRING("off", result.state.repeat);
+  TEST_ASSERT_TRUE(result.state.has_play_state);
+  TEST_ASSERT_TRUE(result.state.playing);
+}
+
+void test_player_markets()
+{
+  Result result;
+  bench("player_markets.json", PLAYER, result);
+  TEST_ASSERT_TRUE(result.has_item);
+  TEST_ASSERT_EQUAL_STRING("Paranoid Android", result.state.track);
+  TEST_ASSERT_TRUE(result.state.playing);
+}
+
+void test_player_many_artists()
+{
+  Result result;
+  bench("player_many_artists.json", PLAYER, result);
+  TEST_ASSERT_TRUE(result.has_item);
+  TEST_ASSERT_EQUAL_STRING("Hopp\xC3\xADpolla", result.state.track);
+  TEST_ASSERT_EQUAL_STRING("Takk...", result.state.album);
+  TEST_ASSERT_EQUAL_STRING("Sigur R\xC3\xB3s", result.state.artist);
+}
+
+void test_player_podcast()
+{
+  Result result;
+  bench("player_podcast.json", PLAYER, result);
+  TEST_ASSERT_FALSE(result.has_item);
+  TEST_ASSERT_TRUE(result.state.has_play_state);
+  TEST_ASSERT_TRUE(result.state.playing);
+}
+
+void test_queue()
+{
+  Result result;
+  bench("queue.json", QUEUE, result);
+  TEST_ASSERT_TRUE(result.has_item);
+  TEST_ASSERT_EQUAL_STRING("Karma Police", result.state.track);
+  TEST_ASSERT_EQUAL_STRING("Radiohead", result.state.artist);
+}
+
+void test_queue_empty()
+{
+  Result result;
+  bench("queue_empty.json", QUEUE, result);
+  TEST_ASSERT_FALSE(result.has_item);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_user);
+  RUN_TEST(test_player_track);
+  RUN_TEST(test_player_markets);
+  RUN_TEST(test_player_many_artists);
+  RUN_TEST(test_player_podcast);
+  RUN_TEST(test_queue);
+  RUN_TEST(test_queue_empty);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include <unity.h>
+#include <limits.h>
+#include "task_scheduler.h"
+
+#define OUTER_BEFORE_US 3000
+#define OUTER_AFTER_US 2000
+#define NESTED_US 1000
+
+// Index of the tasks, in the order they are added
+#define NESTED_TASK 0
+#define OUTER_TASK 1
+
+static TaskScheduler *scheduler;
+static bool outer_due;
+static bool nested_due;
+
+static unsigned long outer_due_cb() { return outer_due ? 0 : ULONG_MAX; }
+static unsigned long nested_due_cb() { return nested_due ? 0 : ULONG_MAX; }
+
+// A poll which yields while it waits for the response, a button is pressed meanwhile
+static void outer_run()
+{
+  outer_due = false;
+  mock::advance_us(OUTER_BEFORE_US);
+  nested_due = true;
+  scheduler->yield_point();
+  mock::advance_us(OUTER_AFTER_US);
+}
+
+static void nested_run()
+{
+  nested_due = false;
+  mock::advance_us(NESTED_US);
+  // Only one level of nesting, a yield of a nested task runs nothing
+  outer_due = true;
+  scheduler->yield_point();
+  outer_due = false;
+}
+
+void setUp()
+{
+  mock::set_ms(1000);
+  scheduler = new TaskScheduler();
+  outer_due = false;
+  nested_due = false;
+  // The nested task has the higher priority like input in the firmware
+  scheduler->add("nested", nested_due_cb, nested_run, 5000, true);
+  scheduler->add("outer", outer_due_cb, outer_run, 10000, false);
+}
+
+void tearDown()
+{
+  delete scheduler;
+}
+
+void test_nested_yield_is_accounted_to_the_nested_task()
+{
+  outer_due = true;
+  scheduler->run();
+
+  TEST_ASSERT_EQUAL(1, scheduler->get_runs(OUTER_TASK));
+  TEST_ASSERT_EQUAL(1, scheduler->get_runs(NESTED_TASK));
+  TEST_ASSERT_EQUAL(NESTED_US, scheduler->get_cpu_us(NESTED_TASK));
+  TEST_ASSERT_EQUAL(NESTED_US, scheduler->get_max_us(NESTED_TASK));
+  TEST_ASSERT_EQUAL(OUTER_BEFORE_US + OUTER_AFTER_US, scheduler->get_cpu_us(OUTER_TASK));
+  TEST_ASSERT_EQUAL(OUTER_BEFORE_US + OUTER_AFTER_US, scheduler->get_max_us(OUTER_TASK));
+}
+
+void test_nested_time_is_reset_between_runs()
+{
+  outer_due = true;
+  scheduler->run();
+  outer_due = true;
+  scheduler->run();
+
+  TEST_ASSERT_EQUAL(2, scheduler->get_runs(OUTER_TASK));
+  TEST_ASSERT_EQUAL(2, scheduler->get_runs(NESTED_TASK));
+  TEST_ASSERT_EQUAL(2 * NESTED_US, scheduler->get_cpu_us(NESTED_TASK));
+  TEST_ASSERT_EQUAL(2 * (OUTER_BEFORE_US + OUTER_AFTER_US), scheduler->get_cpu_us(OUTER_TASK));
+}
+
+void test_task_without_yield_gets_its_whole_time()
+{
+  nested_due = true;
+  scheduler->run();
+
+  TEST_ASSERT_EQUAL(1, scheduler->get_runs(NESTED_TASK));
+  TEST_ASSERT_EQUAL(0, scheduler->get_runs(OUTER_TASK));
+  TEST_ASSERT_EQUAL(NESTED_US, scheduler->get_cpu_us(NESTED_TASK));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_nested_yield_is_accounted_to_the_nested_task);
+  RUN_TEST(test_nested_time_is_reset_between_runs);
+  RUN_TEST(test_task_without_yield_gets_its_whole_time);
+  return UNITY_END();
+}
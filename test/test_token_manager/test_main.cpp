@@ -0,0 +1,107 @@
+#include <unity.h>
+#include <limits.h>
+#include "token_manager.h"
+
+// One hour like the tokens of Spotify
+#define LIFETIME_S 3600
+#define LIFETIME_MS (LIFETIME_S * 1000UL)
+
+static TokenManager tokens;
+
+void setUp()
+{
+  tokens.clear();
+  mock::set_ms(0);
+}
+
+void tearDown() {}
+
+void test_refresh_is_due_ahead_of_expiry()
+{
+  TEST_ASSERT_TRUE(tokens.set_refresh_token("refresh"));
+  TEST_ASSERT_TRUE(tokens.needs_refresh());
+  TEST_ASSERT_TRUE(tokens.set_access_token("access", LIFETIME_S));
+  TEST_ASSERT_FALSE(tokens.needs_refresh());
+  TEST_ASSERT_EQUAL(LIFETIME_MS - TOKEN_REFRESH_AHEAD, tokens.get_refresh_wait());
+
+  mock::set_ms(LIFETIME_MS - TOKEN_REFRESH_AHEAD - 1);
+  TEST_ASSERT_FALSE(tokens.needs_refresh());
+  mock::set_ms(LIFETIME_MS - TOKEN_REFRESH_AHEAD);
+  TEST_ASSERT_TRUE(tokens.needs_refresh());
+  TEST_ASSERT_TRUE(tokens.has_access_token());
+}
+
+void test_short_lifetime_refreshes_after_half()
+{
+  tokens.set_refresh_token("refresh");
+  tokens.set_access_token("access", 60);
+  TEST_ASSERT_EQUAL(30000, tokens.get_refresh_wait());
+  mock::set_ms(30000);
+  TEST_ASSERT_TRUE(tokens.needs_refresh());
+}
+
+void test_expiry_across_millis_wrap()
+{
+  // Granted half an hour before millis() wraps around
+  uint32_t granted_at = UINT32_MAX - LIFETIME_MS / 2;
+  mock::set_ms(granted_at);
+  tokens.set_refresh_token("refresh");
+  tokens.set_access_token("access", LIFETIME_S);
+
+  mock::set_ms(granted_at + LIFETIME_MS / 2 + 1000);
+  TEST_ASSERT_LESS_THAN(granted_at, millis());
+  TEST_ASSERT_FALSE(tokens.needs_refresh());
+  TEST_ASSERT_FALSE(tokens.is_expired());
+  TEST_ASSERT_EQUAL(LIFETIME_MS / 2 - TOKEN_REFRESH_AHEAD - 1000, tokens.get_refresh_wait());
+
+  mock::set_ms(granted_at + LIFETIME_MS - TOKEN_REFRESH_AHEAD);
+  TEST_ASSERT_TRUE(tokens.needs_refresh());
+  TEST_ASSERT_EQUAL(0, tokens.get_refresh_wait());
+  mock::set_ms(granted_at + LIFETIME_MS);
+  TEST_ASSERT_TRUE(tokens.is_expired());
+  TEST_ASSERT_FALSE(tokens.has_access_token());
+}
+
+void test_refresh_is_single_flight()
+{
+  tokens.set_refresh_token("refresh");
+  TEST_ASSERT_TRUE(tokens.begin_refresh());
+  TEST_ASSERT_FALSE(tokens.begin_refresh());
+  TEST_ASSERT_FALSE(tokens.needs_refresh());
+  tokens.end_refresh();
+  TEST_ASSERT_TRUE(tokens.needs_refresh());
+}
+
+void test_cleared_tokens_need_a_login()
+{
+  tokens.set_refresh_token("refresh");
+  tokens.set_access_token("access", LIFETIME_S);
+  tokens.clear();
+  TEST_ASSERT_FALSE(tokens.has_access_token());
+  TEST_ASSERT_FALSE(tokens.needs_refresh());
+  TEST_ASSERT_EQUAL(ULONG_MAX, tokens.get_refresh_wait());
+}
+
+void test_invalid_tokens_are_rejected()
+{
+  TEST_ASSERT_FALSE(tokens.set_access_token(nullptr, LIFETIME_S));
+  TEST_ASSERT_FALSE(tokens.set_access_token("", LIFETIME_S));
+  TEST_ASSERT_FALSE(tokens.set_access_token("access", 0));
+  char too_long[TOKEN_STORE_MAX_LENGTH + 2];
+  memset(too_long, 'a', sizeof(too_long) - 1);
+  too_long[sizeof(too_long) - 1] = '\0';
+  TEST_ASSERT_FALSE(tokens.set_refresh_token(too_long));
+  TEST_ASSERT_FALSE(tokens.has_refresh_token());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_refresh_is_due_ahead_of_expiry);
+  RUN_TEST(test_short_lifetime_refreshes_after_half);
+  RUN_TEST(test_expiry_across_millis_wrap);
+  RUN_TEST(test_refresh_is_single_flight);
+  RUN_TEST(test_cleared_tokens_need_a_login);
+  RUN_TEST(test_invalid_tokens_are_rejected);
+  return UNITY_END();
+}
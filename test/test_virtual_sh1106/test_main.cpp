@@ -0,0 +1,150 @@
+#include <unity.h>
+#include <U8g2lib.h>
+#include <string>
+#include "virtual_sh1106.h"
+
+/*
+  Regression tests of the SH1106 model: what u8g2 sends over the bit banged bus through attach()
+  must come out of the model as the u8g2 buffer, in every mode the firmware uses.
+*/
+
+#define FRAME_SIZE (SH1106_WIDTH * SH1106_HEIGHT / 8)
+
+class TestDisplay : public U8G2
+{
+public:
+  TestDisplay()
+  {
+    u8g2_Setup_sh1106_i2c_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+static TestDisplay display;
+static VirtualSH1106 panel;
+static std::string pbm;
+
+static void append_pbm(const char *s)
+{
+  pbm += s;
+}
+
+static void draw_scene()
+{
+  display.clearBuffer();
+  display.drawFrame(0, 0, SH1106_WIDTH, SH1106_HEIGHT);
+  display.drawBox(3, 5, 40, 17);
+  display.drawDisc(90, 30, 20);
+  display.drawLine(0, 63, 127, 0);
+  display.drawPixel(127, 63);
+  display.sendBuffer();
+}
+
+static void check_glass_shows_buffer()
+{
+  uint8_t glass[FRAME_SIZE];
+  panel.get_frame(glass);
+  TEST_ASSERT_EQUAL_MEMORY(display.getBufferPtr(), glass, FRAME_SIZE);
+}
+
+void setUp()
+{
+  panel.attach(display.getU8x8());
+  display.begin();
+  display.setFlipMode(0);
+  display.setStartLine(0);
+}
+
+void tearDown() {}
+
+void test_glass_shows_the_buffer()
+{
+  draw_scene();
+  check_glass_shows_buffer();
+  TEST_ASSERT_TRUE(panel.is_display_on());
+}
+
+void test_pbm_matches_u8g2()
+{
+  draw_scene();
+  pbm.clear();
+  u8g2_WriteBufferPBM(display.getU8g2(), append_pbm);
+  std::string expected = pbm;
+  pbm.clear();
+  panel.write_pbm(append_pbm);
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), pbm.c_str());
+}
+
+void test_flip_mode_shows_the_same_picture()
+{
+  // u8g2 turns the picture by 180 degrees with the remap commands and another column offset
+  display.setFlipMode(1);
+  draw_scene();
+  uint8_t glass[FRAME_SIZE];
+  panel.get_frame(glass);
+  const uint8_t *buffer = display.getBufferPtr();
+  for (uint16_t y = 0; y < SH1106_HEIGHT; y++)
+    for (uint16_t x = 0; x < SH1106_WIDTH; x++)
+    {
+      uint16_t fx = SH1106_WIDTH - 1 - x;
+      uint16_t fy = SH1106_HEIGHT - 1 - y;
+      uint8_t drawn = (buffer[(fy / 8) * SH1106_WIDTH + fx] >> (fy % 8)) & 1;
+      TEST_ASSERT_EQUAL(drawn, panel.get_pixel(x, y));
+    }
+}
+
+void test_start_line_scrolls_the_ram()
+{
+  draw_scene();
+  display.setStartLine(8);
+  TEST_ASSERT_EQUAL(8, panel.get_start_line());
+  const uint8_t *buffer = display.getBufferPtr();
+  // Glass row 0 shows the second page of the RAM, the last page wraps to the bottom
+  for (uint16_t x = 0; x < SH1106_WIDTH; x++)
+  {
+    TEST_ASSERT_EQUAL(buffer[SH1106_WIDTH + x] & 1, panel.get_pixel(x, 0));
+    TEST_ASSERT_EQUAL(buffer[x] & 1, panel.get_pixel(x, SH1106_HEIGHT - 8));
+  }
+}
+
+void test_tiles_update_only_their_page()
+{
+  draw_scene();
+  uint8_t tile[8] = {0xFF, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0xFF};
+  display.drawTile(2, 3, 1, tile);
+  // The buffer is not touched by drawTile(), apply the tile to it for the comparison
+  memcpy(&display.getBufferPtr()[3 * SH1106_WIDTH + 16], tile, sizeof(tile));
+  check_glass_shows_buffer();
+}
+
+void test_contrast_and_power_save()
+{
+  display.setContrast(0x2A);
+  TEST_ASSERT_EQUAL(0x2A, panel.get_contrast());
+  display.setPowerSave(1);
+  TEST_ASSERT_FALSE(panel.is_display_on());
+  TEST_ASSERT_EQUAL(0, panel.get_pixel(0, 0));
+  display.setPowerSave(0);
+  TEST_ASSERT_TRUE(panel.is_display_on());
+}
+
+void test_bus_counters()
+{
+  panel.reset_counters();
+  draw_scene();
+  // At least one transfer per page, every byte costs nine clock cycles
+  TEST_ASSERT_TRUE(panel.get_transfers() >= SH1106_RAM_PAGES);
+  TEST_ASSERT_TRUE(panel.get_bus_cycles() > 9 * FRAME_SIZE);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_glass_shows_the_buffer);
+  RUN_TEST(test_pbm_matches_u8g2);
+  RUN_TEST(test_flip_mode_shows_the_same_picture);
+  RUN_TEST(test_start_line_scrolls_the_ram);
+  RUN_TEST(test_tiles_update_only_their_page);
+  RUN_TEST(test_contrast_and_power_save);
+  RUN_TEST(test_bus_counters);
+  return UNITY_END();
+}